@@ -32,6 +32,7 @@
 #include <signal.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <sys/ioctl.h>
 #include <sys/types.h>
 #include <sys/socket.h>
 #include <sys/select.h>
@@ -60,6 +61,14 @@
 
 #define STDIO_MAX_FREE_BUF 1024
 
+/*
+ * Maximum number of messages moved through one stream each time the eio
+ * loop finds it ready. Handling more than one message per wakeup keeps
+ * busy streams from paying for a poll() over every stream of the step
+ * for each message.
+ */
+#define STREAM_MSGS_PER_WAKEUP 64
+
 struct io_buf {
 	int ref_count;
 	uint32_t length;
@@ -281,8 +290,24 @@ _server_readable(eio_obj_t *obj)
 	return false;
 }
 
+/* Return true if a whole message header can be read from fd now */
+static bool
+_server_hdr_pending(int fd)
+{
+	int avail = 0;
+
+	if (ioctl(fd, FIONREAD, &avail) < 0)
+		return false;
+
+	return (avail >= g_io_hdr_size);
+}
+
+/*
+ * Read the next message, or the rest of a partially read message, from
+ * the stepd and route it to its output.
+ */
 static int
-_server_read(eio_obj_t *obj, List objs)
+_server_read_msg(eio_obj_t *obj)
 {
 	struct server_io_info *s = (struct server_io_info *) obj->arg;
 	void *buf;
@@ -434,6 +459,30 @@ _server_read(eio_obj_t *obj, List objs)
 	return SLURM_SUCCESS;
 }
 
+static int
+_server_read(eio_obj_t *obj, List objs)
+{
+	struct server_io_info *s = (struct server_io_info *) obj->arg;
+	int i, rc = SLURM_SUCCESS;
+
+	/*
+	 * Keep reading while the next message header is already waiting on
+	 * the socket, as io_hdr_read_fd() blocks until the complete header
+	 * arrives. A partially received body is left for the next wakeup.
+	 */
+	for (i = 0; i < STREAM_MSGS_PER_WAKEUP; i++) {
+		rc = _server_read_msg(obj);
+		if ((rc != SLURM_SUCCESS) || s->in_msg || s->in_eof ||
+		    (obj->fd == -1) || obj->shutdown)
+			break;
+		if (!_outgoing_buf_free(s->cio) ||
+		    !_server_hdr_pending(obj->fd))
+			break;
+	}
+
+	return rc;
+}
+
 static bool
 _server_writable(eio_obj_t *obj)
 {
@@ -568,7 +617,11 @@ static bool _file_writable(eio_obj_t *obj)
 	return false;
 }
 
-static int _file_write(eio_obj_t *obj, List objs)
+/*
+ * Write the next queued message, or the rest of a partially written
+ * message, to the output file.
+ */
+static int _file_write_msg(eio_obj_t *obj)
 {
 	struct file_write_info *info = (struct file_write_info *) obj->arg;
 	void *ptr;
@@ -626,6 +679,22 @@ static int _file_write(eio_obj_t *obj, List objs)
 	return SLURM_SUCCESS;
 }
 
+static int _file_write(eio_obj_t *obj, List objs)
+{
+	struct file_write_info *info = (struct file_write_info *) obj->arg;
+	int i, rc = SLURM_SUCCESS;
+
+	/* Drain the queue until a write comes up short */
+	for (i = 0; i < STREAM_MSGS_PER_WAKEUP; i++) {
+		rc = _file_write_msg(obj);
+		if ((rc != SLURM_SUCCESS) || info->out_msg ||
+		    list_is_empty(info->msg_queue))
+			break;
+	}
+
+	return rc;
+}
+
 /**********************************************************************
  * File read functions
  **********************************************************************/
@@ -84,12 +84,27 @@ void *src;				/* source mmap'd address */
 struct stat f_stat;			/* source file stats */
 job_sbcast_cred_msg_t *sbcast_cred;	/* job alloc info and sbcast cred */
 
+/* broadcast progress shared by the threads sending blocks */
+typedef struct {
+	struct bcast_parameters *params;
+	file_bcast_msg_t *template;	/* next block's common fields */
+	pthread_mutex_t mutex;		/* protects everything below */
+	void *position;			/* next byte of the file to send */
+	int64_t remaining;		/* bytes of the file left to send */
+	file_bcast_msg_t *last_msg;	/* last block, sent after all others */
+	int rc;
+	uint64_t size_uncompressed;
+	uint64_t size_compressed;
+	uint32_t time_compression;
+} bcast_state_t;
+
 static int   _bcast_file(struct bcast_parameters *params);
 static int   _file_bcast(struct bcast_parameters *params,
 			 file_bcast_msg_t *bcast_msg,
 			 job_sbcast_cred_msg_t *sbcast_cred);
 static int   _file_state(struct bcast_parameters *params);
 static int   _get_job_info(struct bcast_parameters *params);
+static bool  _offset_write_supported(struct bcast_parameters *params);
 
 
 static int _file_state(struct bcast_parameters *params)
@@ -128,6 +143,31 @@ static int _file_state(struct bcast_parameters *params)
 }
 
 /* get details about this slurm job: jobid and allocated node */
+/*
+ * Blocks sent in parallel arrive out of order. Slurmd daemons older than
+ * 19.05 ignore block_offset and append blocks in arrival order, so only
+ * send in parallel if the job's nodes all run 19.05 or newer.
+ */
+static bool _offset_write_supported(struct bcast_parameters *params)
+{
+	job_info_msg_t *job_info = NULL;
+	uint16_t min_ver = SLURM_PROTOCOL_VERSION;
+	int i;
+
+	if (slurm_load_job(&job_info, params->job_id, SHOW_ALL)) {
+		verbose("Slurm job ID %u load error: %s", params->job_id,
+			slurm_strerror(slurm_get_errno()));
+		return false;
+	}
+	for (i = 0; i < job_info->record_count; i++) {
+		min_ver = MIN(min_ver,
+			      job_info->job_array[i].start_protocol_ver);
+	}
+	slurm_free_job_info_msg(job_info);
+
+	return (min_ver >= SLURM_19_05_PROTOCOL_VERSION);
+}
+
 static int _get_job_info(struct bcast_parameters *params)
 {
 	int rc;
@@ -218,44 +258,15 @@ static int _file_bcast(struct bcast_parameters *params,
 	return rc;
 }
 
-/* load a buffer with data from the file to broadcast,
- * return number of bytes read, zero on end of file */
-static int _get_block_none(char **buffer, int *orig_len, bool *more)
-{
-	static int64_t remaining = -1;
-	static void *position;
-	int size;
-
-	if (remaining < 0) {
-		*buffer = xmalloc(block_len);
-		remaining = f_stat.st_size;
-		position = src;
-	}
-
-	size = MIN(block_len, remaining);
-	memcpy(*buffer, position, size);
-	remaining -= size;
-	position += size;
-
-	*orig_len = size;
-	*more = (remaining) ? true : false;
-	return size;
-}
-
-static int _get_block_zlib(struct bcast_parameters *params,
-			   char **buffer,
-			   int *orig_len,
-			   bool *more)
+/* compress a block with zlib, sending it uncompressed on failure */
+static void _compress_block_zlib(void *position, int size,
+				 file_bcast_msg_t *msg)
 {
 #if HAVE_LIBZ
-	static z_stream strm;
+	z_stream strm;
 	int chunk = (256 * 1024);
 	int flush = Z_NO_FLUSH;
-
-	static int64_t remaining = -1;
-	static int max_out;
-	static void *position;
-	int chunk_remaining, out_remaining, chunk_bite, size = 0;
+	int max_out, chunk_remaining, out_remaining, chunk_bite;
 
 	/* allocate deflate state, compress each block independently */
 	strm.zalloc = Z_NULL;
@@ -265,22 +276,19 @@ static int _get_block_zlib(struct bcast_parameters *params,
 	strm.next_in = Z_NULL;
 	if (deflateInit(&strm, Z_DEFAULT_COMPRESSION) != Z_OK) {
 		error("File compression configuration error,"
-		      "sending uncompressed file.");
-		params->compress = 0;
-		return _get_block_none(buffer, orig_len, more);
+		      "sending block %u uncompressed.", msg->block_no);
+		msg->compress = COMPRESS_OFF;
+		msg->block = position;
+		msg->block_len = size;
+		return;
 	}
 
-	/* first pass through, initialize */
-	if (remaining < 0) {
-		remaining = f_stat.st_size;
-		max_out = deflateBound(&strm, block_len);
-		*buffer = xmalloc(max_out);
-		position = src;
-	}
+	max_out = deflateBound(&strm, size);
+	msg->block = xmalloc(max_out);
 
-	chunk_remaining = MIN(block_len, remaining);
+	chunk_remaining = size;
 	out_remaining = max_out;
-	strm.next_out = (void *) *buffer;
+	strm.next_out = (void *) msg->block;
 	while (chunk_remaining) {
 		strm.next_in = position;
 		chunk_bite = MIN(chunk, chunk_remaining);
@@ -294,106 +302,181 @@ static int _get_block_zlib(struct bcast_parameters *params,
 			fatal("Error compressing file");
 
 		position += chunk_bite;
-		size += chunk_bite;
 		chunk_remaining -= chunk_bite;
 		out_remaining = strm.avail_out;
 	}
-	remaining -= size;
 
 	(void) deflateEnd(&strm);
 
-	*orig_len = size;
-	*more = (remaining) ? true : false;
-	return (max_out - out_remaining);
-#else
-	info("zlib compression not supported, sending uncompressed file.");
-	params->compress = 0;
-	return _get_block_none(buffer, orig_len, more);
+	msg->block_len = max_out - out_remaining;
 #endif
 }
 
-static int _get_block_lz4(struct bcast_parameters *params,
-			  char **buffer,
-			  int32_t *orig_len,
-			  bool *more)
+/*
+ * compress the start of the remaining file data with lz4, return the number
+ * of bytes of the file consumed
+ */
+static int _compress_block_lz4(void *position, int64_t remaining,
+			       file_bcast_msg_t *msg)
 {
 #if HAVE_LZ4
-	int size_out;
-	static int64_t remaining = -1;
-	static void *position;
 	int size;
 
-	if (!f_stat.st_size) {
-		*more = false;
+	if (!remaining)
 		return 0;
-	}
-
-	if (remaining < 0) {
-		position = src;
-		remaining = f_stat.st_size;
-		*buffer = xmalloc(block_len);
-	}
 
 	/* intentionally limit decompressed size to 10x compressed
 	 * to avoid problems on receive size when decompressed */
 	size = MIN(block_len * 10, remaining);
-	if (!(size_out = LZ4_compress_destSize(position, *buffer,
-					       &size, block_len))) {
+	msg->block = xmalloc(block_len);
+	if (!(msg->block_len = LZ4_compress_destSize(position, msg->block,
+						     &size, block_len))) {
 		/* compression failure */
 		fatal("LZ4 compression error");
 	}
-	position += size;
-	remaining -= size;
-
-	*orig_len = size;
-	*more = (remaining) ? true : false;
-	return size_out;
+	return size;
 #else
-	info("lz4 compression not supported, sending uncompressed file.");
-	params->compress = 0;
-	return _get_block_none(buffer, orig_len, more);
+	return 0;
 #endif
+}
 
+/*
+ * Take the next block of the file to broadcast, compressing it as needed.
+ * RET the block's message or NULL if there are no blocks left to send or
+ *     the broadcast failed. Release with _free_block().
+ */
+static file_bcast_msg_t *_next_block(bcast_state_t *state)
+{
+	file_bcast_msg_t *msg;
+	void *position;
+	int size;
+	DEF_TIMERS;
+
+	slurm_mutex_lock(&state->mutex);
+	if (state->rc ||
+	    ((state->template->block_no > 1) && !state->remaining)) {
+		slurm_mutex_unlock(&state->mutex);
+		return NULL;
+	}
+	msg = xmalloc(sizeof(file_bcast_msg_t));
+	*msg = *state->template;
+	state->template->block_no++;
+	position = state->position;
+
+	/*
+	 * lz4 decides how much of the file goes into a block, so the
+	 * blocks must be compressed in order.
+	 */
+	if (msg->compress == COMPRESS_LZ4) {
+		START_TIMER;
+		size = _compress_block_lz4(position, state->remaining, msg);
+		END_TIMER;
+		state->time_compression += DELTA_TIMER;
+	} else
+		size = MIN(block_len, state->remaining);
+
+	state->position += size;
+	state->remaining -= size;
+	state->template->block_offset += size;
+	msg->uncomp_len = size;
+	if (!state->remaining)
+		msg->last_block = 1;
+	slurm_mutex_unlock(&state->mutex);
+
+	if (msg->compress == COMPRESS_ZLIB) {
+		START_TIMER;
+		_compress_block_zlib(position, size, msg);
+		END_TIMER;
+		slurm_mutex_lock(&state->mutex);
+		state->time_compression += DELTA_TIMER;
+		slurm_mutex_unlock(&state->mutex);
+	} else if (msg->compress == COMPRESS_OFF) {
+		/* send straight from the mmap'd file */
+		msg->block = position;
+		msg->block_len = size;
+	}
+
+	return msg;
 }
 
-static int _next_block(struct bcast_parameters *params,
-		       char **buffer,
-		       int32_t *orig_len,
-		       bool *more)
+static void _free_block(file_bcast_msg_t *msg)
 {
-	switch (params->compress) {
-	case COMPRESS_OFF:
-		return _get_block_none(buffer, orig_len, more);
-	case COMPRESS_ZLIB:
-		return _get_block_zlib(params, buffer, orig_len, more);
-	case COMPRESS_LZ4:
-		return _get_block_lz4(params, buffer, orig_len, more);
+	if (msg->compress != COMPRESS_OFF)
+		xfree(msg->block);
+	xfree(msg);
+}
+
+static void _send_block(bcast_state_t *state, file_bcast_msg_t *msg)
+{
+	int rc;
+
+	debug("block %u, size %u", msg->block_no, msg->block_len);
+	rc = _file_bcast(state->params, msg, sbcast_cred);
+
+	slurm_mutex_lock(&state->mutex);
+	state->size_uncompressed += msg->uncomp_len;
+	state->size_compressed += msg->block_len;
+	if (rc != SLURM_SUCCESS)
+		state->rc = MAX(state->rc, rc);
+	slurm_mutex_unlock(&state->mutex);
+}
+
+/*
+ * Send blocks until none are left. The last block is left for the caller to
+ * send once every other block has been written.
+ */
+static void *_bcast_blocks(void *arg)
+{
+	bcast_state_t *state = (bcast_state_t *) arg;
+	file_bcast_msg_t *msg;
+
+	while ((msg = _next_block(state))) {
+		if (msg->last_block) {
+			state->last_msg = msg;
+			break;
+		}
+		_send_block(state, msg);
+		_free_block(msg);
 	}
 
-	/* compression type not recognized */
-	error("File compression type %u not supported,"
-	      " sending uncompressed file.", params->compress);
-	params->compress = 0;
-	return _get_block_none(buffer, orig_len, more);
+	return NULL;
 }
 
 /* read and broadcast the file */
 static int _bcast_file(struct bcast_parameters *params)
 {
-	int rc = SLURM_SUCCESS;
-	file_bcast_msg_t bcast_msg;
-	char *buffer = NULL;
-	int32_t orig_len = 0;
-	uint64_t size_uncompressed = 0, size_compressed = 0;
-	uint32_t time_compression = 0;
-	bool more = true;
-	DEF_TIMERS;
+	file_bcast_msg_t bcast_msg, *msg;
+	bcast_state_t state;
+	pthread_t *threads;
+	int i, window;
 
 	if (params->block_size)
 		block_len = MIN(params->block_size, f_stat.st_size);
 	else
 		block_len = MIN((512 * 1024), f_stat.st_size);
 
+	switch (params->compress) {
+	case COMPRESS_OFF:
+		break;
+	case COMPRESS_ZLIB:
+#if !HAVE_LIBZ
+		info("zlib compression not supported, sending uncompressed file.");
+		params->compress = COMPRESS_OFF;
+#endif
+		break;
+	case COMPRESS_LZ4:
+#if !HAVE_LZ4
+		info("lz4 compression not supported, sending uncompressed file.");
+		params->compress = COMPRESS_OFF;
+#endif
+		break;
+	default:
+		/* compression type not recognized */
+		error("File compression type %u not supported,"
+		      " sending uncompressed file.", params->compress);
+		params->compress = COMPRESS_OFF;
+	}
+
 	memset(&bcast_msg, 0, sizeof(file_bcast_msg_t));
 	bcast_msg.fname		= params->dst_fname;
 	bcast_msg.block_no	= 1;
@@ -404,6 +487,7 @@ static int _bcast_file(struct bcast_parameters *params)
 	bcast_msg.gid		= f_stat.st_gid;
 	bcast_msg.file_size	= f_stat.st_size;
 	bcast_msg.cred          = sbcast_cred->sbcast_cred;
+	bcast_msg.compress	= params->compress;
 
 	if (params->preserve) {
 		bcast_msg.atime     = f_stat.st_atime;
@@ -414,47 +498,68 @@ static int _bcast_file(struct bcast_parameters *params)
 		params->fanout = MAX_THREADS;
 	slurm_set_tree_width(MIN(MAX_THREADS, params->fanout));
 
-	while (more) {
-		START_TIMER;
-		bcast_msg.block_len = _next_block(params, &buffer, &orig_len,
-						  &more);
-		END_TIMER;
-		time_compression += DELTA_TIMER;
-		size_uncompressed += orig_len;
-		size_compressed += bcast_msg.block_len;
-		debug("block %u, size %u", bcast_msg.block_no,
-		      bcast_msg.block_len);
-		bcast_msg.compress = params->compress;
-		bcast_msg.uncomp_len = orig_len;
-		bcast_msg.block = buffer;
-		if (!more)
-			bcast_msg.last_block = 1;
-
-		rc = _file_bcast(params, &bcast_msg, sbcast_cred);
-		if (rc != SLURM_SUCCESS)
-			break;
-		if (bcast_msg.last_block)
-			break;	/* end of file */
-		bcast_msg.block_no++;
-		bcast_msg.block_offset += orig_len;
+	memset(&state, 0, sizeof(bcast_state_t));
+	slurm_mutex_init(&state.mutex);
+	state.params = params;
+	state.template = &bcast_msg;
+	state.position = src;
+	state.remaining = f_stat.st_size;
+
+	/*
+	 * The first block opens the file on the nodes, so it is sent by
+	 * itself. Blocks are written at their offsets, so the ones between
+	 * the first and the last may then be sent in parallel. The last
+	 * block sets the file's modes and closes it, so it is sent once all
+	 * the others have been written.
+	 */
+	msg = _next_block(&state);
+	if (msg->last_block) {
+		state.last_msg = msg;
+	} else {
+		_send_block(&state, msg);
+		_free_block(msg);
+	}
+
+	/* Each window thread forwards its block to up to fanout nodes */
+	window = MIN(MAX_THREADS, MAX(1, params->window));
+	if ((window > 1) && !_offset_write_supported(params)) {
+		info("Slurm on the job's nodes is too old to receive blocks in parallel, sending them one at a time");
+		window = 1;
+	}
+	if (!state.last_msg && (window > 1)) {
+		threads = xmalloc(sizeof(pthread_t) * window);
+		for (i = 0; i < window; i++)
+			slurm_thread_create(&threads[i], _bcast_blocks, &state);
+		for (i = 0; i < window; i++)
+			pthread_join(threads[i], NULL);
+		xfree(threads);
+	} else if (!state.last_msg) {
+		_bcast_blocks(&state);
+	}
+
+	if (state.last_msg) {
+		if (state.rc == SLURM_SUCCESS)
+			_send_block(&state, state.last_msg);
+		_free_block(state.last_msg);
 	}
 	xfree(bcast_msg.user_name);
-	xfree(buffer);
+	slurm_mutex_destroy(&state.mutex);
 
-	if (size_uncompressed && (params->compress != 0)) {
-		int64_t pct = (int64_t) size_uncompressed - size_compressed;
+	if (state.size_uncompressed && (params->compress != 0)) {
+		int64_t pct = (int64_t) state.size_uncompressed -
+			      state.size_compressed;
 		/* Dividing a negative by a positive in C99 results in
 		 * "truncation towards zero" which gives unexpected values for
 		 * pct. This construct avoids that problem.
 		 */
-		pct = (pct>=0) ? pct * 100 / size_uncompressed
-			       : - (-pct * 100 / size_uncompressed);
+		pct = (pct>=0) ? pct * 100 / state.size_uncompressed
+			       : - (-pct * 100 / state.size_uncompressed);
 		verbose("File compressed from %"PRIu64" to %"PRIu64" (%d percent) in %u usec",
-			size_uncompressed, size_compressed, (int) pct,
-			time_compression);
+			state.size_uncompressed, state.size_compressed,
+			(int) pct, state.time_compression);
 	}
 
-	return rc;
+	return state.rc;
 }
 
 
@@ -53,6 +53,7 @@ struct bcast_parameters {
 	uint32_t step_id;
 	int timeout;
 	int verbose;
+	int window;			/* blocks sent in parallel */
 };
 
 typedef struct file_bcast_info {
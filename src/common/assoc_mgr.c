@@ -45,6 +45,7 @@
 #include <ctype.h>
 
 #include "src/common/uid.h"
+#include "src/common/xhash.h"
 #include "src/common/xstring.h"
 #include "src/common/slurm_priority.h"
 #include "src/common/slurmdbd_pack.h"
@@ -78,6 +79,39 @@ static slurmdb_assoc_rec_t **assoc_hash_id = NULL;
 static slurmdb_assoc_rec_t **assoc_hash = NULL;
 static int *assoc_mgr_tres_old_pos = NULL;
 
+/*
+ * ASSOC_MGR_TRES_* flags of each association and QOS, keyed by record id.
+ * Kept here instead of in the slurmdb usage structures so the public
+ * structure layout does not change. Protected by the assoc and QOS locks
+ * respectively.
+ */
+typedef struct {
+	uint32_t id;
+	uint32_t flags;
+} tres_unlimited_t;
+
+static xhash_t *assoc_tres_unlimited = NULL;
+static xhash_t *qos_tres_unlimited = NULL;
+
+/*
+ * Generation of the association/QOS definitions. Bumped while holding the
+ * assoc and/or QOS write lock whenever records are added, removed or
+ * modified, so a reader may cache anything derived from them and only
+ * retake the assoc_mgr locks once the generation has moved on.
+ * The assoc and QOS write locks are independent and assoc_mgr_get_conf_gen()
+ * takes no lock, so it is only accessed atomically. The release on update
+ * pairs with the acquire in assoc_mgr_get_conf_gen(), so a reader seeing a
+ * new generation also sees the record changes made before it.
+ */
+static uint32_t assoc_mgr_conf_gen = 1;
+
+static void _publish_conf_gen(void)
+{
+	/* Skip 0, callers use it for "no generation cached" */
+	if (__atomic_add_fetch(&assoc_mgr_conf_gen, 1, __ATOMIC_ACQ_REL) == 0)
+		__atomic_add_fetch(&assoc_mgr_conf_gen, 1, __ATOMIC_ACQ_REL);
+}
+
 static bool _running_cache(void)
 {
 	if (init_setup.running_cache && *init_setup.running_cache)
@@ -985,6 +1019,120 @@ static void _set_children_level_shares(slurmdb_assoc_rec_t *assoc,
 	list_iterator_destroy(itr);
 }
 
+static bool _tres_cnt_unlimited(uint64_t *tres_cnt)
+{
+	if (!tres_cnt)
+		return false;
+
+	for (int i = 0; i < g_tres_count; i++) {
+		if (tres_cnt[i] != INFINITE64)
+			return false;
+	}
+
+	return true;
+}
+
+static void _tres_unlimited_id(void *item, const char **key,
+			       uint32_t *key_len)
+{
+	tres_unlimited_t *ent = item;
+
+	*key = (const char *) &ent->id;
+	*key_len = sizeof(ent->id);
+}
+
+static void _tres_unlimited_free(void *item)
+{
+	xfree(item);
+}
+
+static void _set_tres_unlimited(xhash_t **table, uint32_t id, uint32_t flags)
+{
+	tres_unlimited_t *ent;
+
+	if (!*table)
+		*table = xhash_init(_tres_unlimited_id, _tres_unlimited_free);
+
+	if (!(ent = xhash_get(*table, (char *) &id, sizeof(id)))) {
+		ent = xmalloc(sizeof(tres_unlimited_t));
+		ent->id = id;
+		xhash_add(*table, ent);
+	}
+	ent->flags = flags;
+}
+
+static uint32_t _get_tres_unlimited(xhash_t *table, uint32_t id)
+{
+	tres_unlimited_t *ent;
+
+	if (!table || !(ent = xhash_get(table, (char *) &id, sizeof(id))))
+		return 0;
+
+	return ent->flags;
+}
+
+static void _del_tres_unlimited(xhash_t *table, uint32_t id)
+{
+	if (table)
+		xhash_delete(table, (char *) &id, sizeof(id));
+}
+
+/* Refresh the unlimited flags of assoc after any *_ctld array changed */
+static void _set_assoc_tres_unlimited(slurmdb_assoc_rec_t *assoc)
+{
+	uint32_t flags = 0;
+
+	/* Only slurmctld checks limits, skip the temporary records it uses */
+	if (slurmdbd_conf || !assoc->usage)
+		return;
+
+	if (_tres_cnt_unlimited(assoc->grp_tres_ctld))
+		flags |= ASSOC_MGR_TRES_GRP;
+	if (_tres_cnt_unlimited(assoc->grp_tres_mins_ctld))
+		flags |= ASSOC_MGR_TRES_GRP_MINS;
+	if (_tres_cnt_unlimited(assoc->grp_tres_run_mins_ctld))
+		flags |= ASSOC_MGR_TRES_GRP_RUN_MINS;
+	if (_tres_cnt_unlimited(assoc->max_tres_ctld))
+		flags |= ASSOC_MGR_TRES_MAX_PJ;
+	if (_tres_cnt_unlimited(assoc->max_tres_pn_ctld))
+		flags |= ASSOC_MGR_TRES_MAX_PN;
+	if (_tres_cnt_unlimited(assoc->max_tres_mins_ctld))
+		flags |= ASSOC_MGR_TRES_MAX_MINS_PJ;
+
+	_set_tres_unlimited(&assoc_tres_unlimited, assoc->id, flags);
+}
+
+/* Refresh the unlimited flags of qos after any *_ctld array changed */
+static void _set_qos_tres_unlimited(slurmdb_qos_rec_t *qos)
+{
+	uint32_t flags = 0;
+
+	/* Only slurmctld checks limits, skip the temporary records it uses */
+	if (slurmdbd_conf || !qos->usage)
+		return;
+
+	if (_tres_cnt_unlimited(qos->grp_tres_ctld))
+		flags |= ASSOC_MGR_TRES_GRP;
+	if (_tres_cnt_unlimited(qos->grp_tres_mins_ctld))
+		flags |= ASSOC_MGR_TRES_GRP_MINS;
+	if (_tres_cnt_unlimited(qos->grp_tres_run_mins_ctld))
+		flags |= ASSOC_MGR_TRES_GRP_RUN_MINS;
+	if (_tres_cnt_unlimited(qos->max_tres_pj_ctld))
+		flags |= ASSOC_MGR_TRES_MAX_PJ;
+	if (_tres_cnt_unlimited(qos->max_tres_pn_ctld))
+		flags |= ASSOC_MGR_TRES_MAX_PN;
+	if (_tres_cnt_unlimited(qos->max_tres_mins_pj_ctld))
+		flags |= ASSOC_MGR_TRES_MAX_MINS_PJ;
+	if (_tres_cnt_unlimited(qos->max_tres_pa_ctld))
+		flags |= ASSOC_MGR_TRES_MAX_PA;
+	if (_tres_cnt_unlimited(qos->max_tres_pu_ctld))
+		flags |= ASSOC_MGR_TRES_MAX_PU;
+	if (_tres_cnt_unlimited(qos->min_tres_pj_ctld))
+		flags |= ASSOC_MGR_TRES_MIN_PJ;
+
+	_set_tres_unlimited(&qos_tres_unlimited, qos->id, flags);
+}
+
 /* transfer slurmdb assoc list to be assoc_mgr assoc list */
 static int _post_assoc_list(void)
 {
@@ -1004,6 +1152,7 @@ static int _post_assoc_list(void)
 
 	xfree(assoc_hash_id);
 	xfree(assoc_hash);
+	xhash_clear(assoc_tres_unlimited);
 
 	itr = list_iterator_create(assoc_mgr_assoc_list);
 
@@ -1038,6 +1187,7 @@ static int _post_assoc_list(void)
 	_calculate_assoc_norm_priorities(true);
 
 	slurmdb_sort_hierarchical_assoc_list(assoc_mgr_assoc_list, true);
+	_publish_conf_gen();
 
 	//END_TIMER2("load_associations");
 	return SLURM_SUCCESS;
@@ -1100,6 +1250,7 @@ static int _post_qos_list(List qos_list)
 
 	g_qos_count = 0;
 	g_qos_max_priority = 0;
+	xhash_clear(qos_tres_unlimited);
 
 	while ((qos = list_next(itr))) {
 		if (qos->flags & QOS_FLAG_NOTSET)
@@ -1130,6 +1281,7 @@ static int _post_qos_list(List qos_list)
 			_set_qos_norm_priority(qos);
 	}
 	list_iterator_destroy(itr);
+	_publish_conf_gen();
 
 	return SLURM_SUCCESS;
 }
@@ -2101,6 +2253,8 @@ extern int assoc_mgr_fini(bool save_state)
 	xfree(assoc_mgr_tres_array);
 	xfree(assoc_mgr_tres_old_pos);
 	xfree(assoc_mgr_cluster_name);
+	xhash_free(assoc_tres_unlimited);
+	xhash_free(qos_tres_unlimited);
 	assoc_mgr_assoc_list = NULL;
 	assoc_mgr_res_list = NULL;
 	assoc_mgr_qos_list = NULL;
@@ -2114,6 +2268,7 @@ extern int assoc_mgr_fini(bool save_state)
 
 	xfree(assoc_hash_id);
 	xfree(assoc_hash);
+	_publish_conf_gen();
 
 	assoc_mgr_unlock(&locks);
 
@@ -2173,6 +2328,26 @@ bool verify_assoc_lock(assoc_mgr_lock_datatype_t datatype, lock_level_t level)
 }
 #endif
 
+extern uint32_t assoc_mgr_get_assoc_tres_unlimited(
+	slurmdb_assoc_rec_t *assoc)
+{
+	xassert(verify_assoc_lock(ASSOC_LOCK, READ_LOCK));
+
+	return _get_tres_unlimited(assoc_tres_unlimited, assoc->id);
+}
+
+extern uint32_t assoc_mgr_get_qos_tres_unlimited(slurmdb_qos_rec_t *qos)
+{
+	xassert(verify_assoc_lock(QOS_LOCK, READ_LOCK));
+
+	return _get_tres_unlimited(qos_tres_unlimited, qos->id);
+}
+
+extern uint32_t assoc_mgr_get_conf_gen(void)
+{
+	return __atomic_load_n(&assoc_mgr_conf_gen, __ATOMIC_ACQUIRE);
+}
+
 extern void assoc_mgr_lock(assoc_mgr_lock_t *locks)
 {
 	static bool init_run = false;
@@ -3922,6 +4097,8 @@ extern int assoc_mgr_update_assocs(slurmdb_update_object_t *update, bool locked)
 
 			/* info("now rec has def of %d", rec->def_qos_id); */
 
+			_set_assoc_tres_unlimited(rec);
+
 			if (update_jobs && init_setup.update_assoc_notify) {
 				/* since there are some deadlock
 				   issues while inside our lock here
@@ -3995,6 +4172,7 @@ extern int assoc_mgr_update_assocs(slurmdb_update_object_t *update, bool locked)
 				redo_priority = 2;
 
 			_delete_assoc_hash(rec);
+			_del_tres_unlimited(assoc_tres_unlimited, rec->id);
 			_remove_from_assoc_list(rec);
 			if (init_setup.remove_assoc_notify) {
 				/* since there are some deadlock
@@ -4119,6 +4297,7 @@ extern int assoc_mgr_update_assocs(slurmdb_update_object_t *update, bool locked)
 	} else if (resort)
 		slurmdb_sort_hierarchical_assoc_list(
 			assoc_mgr_assoc_list, true);
+	_publish_conf_gen();
 
 	if (!locked)
 		assoc_mgr_unlock(&locks);
@@ -4697,6 +4876,8 @@ extern int assoc_mgr_update_qos(slurmdb_update_object_t *update, bool locked)
 			if (!fuzzy_equal(object->usage_thres, NO_VAL))
 				rec->usage_thres = object->usage_thres;
 
+			_set_qos_tres_unlimited(rec);
+
 			if (update_jobs && init_setup.update_qos_notify) {
 				/* since there are some deadlock
 				   issues while inside our lock here
@@ -4718,6 +4899,7 @@ extern int assoc_mgr_update_qos(slurmdb_update_object_t *update, bool locked)
 			if (rec->priority == g_qos_max_priority)
 				redo_priority = 2;
 
+			_del_tres_unlimited(qos_tres_unlimited, rec->id);
 			if (init_setup.remove_qos_notify) {
 				/* since there are some deadlock
 				   issues while inside our lock here
@@ -4801,6 +4983,7 @@ extern int assoc_mgr_update_qos(slurmdb_update_object_t *update, bool locked)
 		_post_qos_list(assoc_mgr_qos_list);
 
 	list_iterator_destroy(itr);
+	_publish_conf_gen();
 
 	if (!locked)
 		assoc_mgr_unlock(&locks);
@@ -6389,6 +6572,7 @@ extern void assoc_mgr_set_assoc_tres_cnt(slurmdb_assoc_rec_t *assoc)
 				     assoc->max_tres_mins_pj, INFINITE64, 1);
 	assoc_mgr_set_tres_cnt_array(&assoc->max_tres_run_mins_ctld,
 				     assoc->max_tres_run_mins, INFINITE64, 1);
+	_set_assoc_tres_unlimited(assoc);
 }
 
 /* tres read lock needs to be locked before this is called. */
@@ -6422,6 +6606,7 @@ extern void assoc_mgr_set_qos_tres_cnt(slurmdb_qos_rec_t *qos)
 				     qos->max_tres_run_mins_pu, INFINITE64, 1);
 	assoc_mgr_set_tres_cnt_array(&qos->min_tres_pj_ctld,
 				     qos->min_tres_pj, INFINITE64, 1);
+	_set_qos_tres_unlimited(qos);
 }
 
 extern char *assoc_mgr_make_tres_str_from_array(
@@ -60,6 +60,22 @@
 #define ASSOC_MGR_CACHE_TRES  0x0020
 #define ASSOC_MGR_CACHE_ALL   0xffff
 
+/*
+ * Flags returned by assoc_mgr_get_assoc_tres_unlimited() and
+ * assoc_mgr_get_qos_tres_unlimited(). A flag is set when the matching *_ctld
+ * array of the association or QOS has no limit on any TRES, so limit checks
+ * can skip it without walking every TRES.
+ */
+#define ASSOC_MGR_TRES_GRP		0x0001 /* grp_tres_ctld */
+#define ASSOC_MGR_TRES_GRP_MINS		0x0002 /* grp_tres_mins_ctld */
+#define ASSOC_MGR_TRES_GRP_RUN_MINS	0x0004 /* grp_tres_run_mins_ctld */
+#define ASSOC_MGR_TRES_MAX_PJ		0x0008 /* max_tres[_pj]_ctld */
+#define ASSOC_MGR_TRES_MAX_PN		0x0010 /* max_tres_pn_ctld */
+#define ASSOC_MGR_TRES_MAX_MINS_PJ	0x0020 /* max_tres_mins[_pj]_ctld */
+#define ASSOC_MGR_TRES_MAX_PA		0x0040 /* max_tres_pa_ctld */
+#define ASSOC_MGR_TRES_MAX_PU		0x0080 /* max_tres_pu_ctld */
+#define ASSOC_MGR_TRES_MIN_PJ		0x0100 /* min_tres_pj_ctld */
+
 /* to lock or not */
 typedef struct {
 	lock_level_t assoc;
@@ -128,6 +144,25 @@ extern void assoc_mgr_unlock(assoc_mgr_lock_t *locks);
 extern bool verify_assoc_lock(assoc_mgr_lock_datatype_t datatype, lock_level_t level);
 #endif
 
+/*
+ * Return the ASSOC_MGR_TRES_* flags of the limit arrays of assoc (qos) that
+ * have no TRES limit set. Returns 0, meaning check every array, for a record
+ * assoc_mgr has not seen.
+ * NOTE: The assoc (QOS) read lock must be held when calling these.
+ */
+extern uint32_t assoc_mgr_get_assoc_tres_unlimited(
+	slurmdb_assoc_rec_t *assoc);
+extern uint32_t assoc_mgr_get_qos_tres_unlimited(slurmdb_qos_rec_t *qos);
+
+/*
+ * Return the current generation of the association and QOS definitions.
+ * The value changes whenever an association or QOS is added, removed or
+ * modified (not when only usage changes). It may be read without holding
+ * any assoc_mgr lock; when read while holding the assoc or QOS read lock it
+ * matches the records visible under that lock.
+ */
+extern uint32_t assoc_mgr_get_conf_gen(void);
+
 /* ran after a new tres_list is given */
 extern int assoc_mgr_post_tres_list(List new_list);
 
@@ -40,6 +40,7 @@
 
 #include <errno.h>
 #include <poll.h>
+#include <stdlib.h>
 #include <sys/types.h>
 #include <sys/socket.h>
 #include <unistd.h>
@@ -48,6 +49,11 @@
 #define POLLRDHUP POLLHUP
 #endif
 
+#if defined(__linux__)
+#include <sys/epoll.h>
+#define EIO_HAVE_EPOLL 1
+#endif
+
 #include "src/common/fd.h"
 #include "src/common/eio.h"
 #include "src/common/log.h"
@@ -56,6 +62,7 @@
 #include "src/common/slurm_protocol_api.h"
 #include "src/common/xassert.h"
 #include "src/common/xmalloc.h"
+#include "src/common/xstring.h"
 
 /*
  * Define slurm-specific aliases for use by plugins, see slurm_xlator.h
@@ -74,6 +81,25 @@ strong_alias(eio_remove_obj,		slurm_eio_remove_obj);
 strong_alias(eio_signal_shutdown,	slurm_eio_signal_shutdown);
 strong_alias(eio_signal_wakeup,		slurm_eio_signal_wakeup);
 
+/*
+ * Event backends of the main loop, set with the SLURM_EIO_BACKEND
+ * environment variable ("poll" or "epoll", default "poll").
+ */
+#define EIO_BACKEND_POLL	0
+#define EIO_BACKEND_EPOLL	1
+
+#ifdef EIO_HAVE_EPOLL
+/* State of one file descriptor watched through epoll */
+typedef struct {
+	eio_obj_t *obj;		/* object watching the fd */
+	uint32_t obj_id;	/* its eio_obj_t id, as obj may be reused */
+	uint32_t events;	/* events registered with epoll, 0 if none */
+	uint32_t iter;		/* last loop iteration the fd was watched */
+	bool in_reg;		/* fd is in the epoll_reg array */
+	bool no_epoll;		/* fd type can not be used with epoll */
+} eio_epoll_fd_t;
+#endif
+
 /*
  * outside threads can stick new objects on the new_objs List and
  * the eio thread will move them to the main obj_list the next time
@@ -90,13 +116,32 @@ struct eio_handle_components {
 	uint16_t shutdown_wait;
 	List obj_list;
 	List new_objs;
+	int backend;		/* EIO_BACKEND_* */
+#ifdef EIO_HAVE_EPOLL
+	/*
+	 * Objects are registered with epfd when their interest changes
+	 * rather than handed to the kernel on every loop iteration. Objects
+	 * whose fd can not be used with epoll (e.g. regular files) or whose
+	 * fd is shared with another object are still polled directly.
+	 */
+	int epfd;		/* epoll instance, -1 if not in use */
+	uint32_t epoll_iter;	/* current loop iteration */
+	eio_epoll_fd_t *epoll_fd; /* indexed by file descriptor */
+	int epoll_fd_size;
+	int *epoll_reg;		/* file descriptors registered with epfd */
+	int epoll_reg_cnt;
+	int epoll_reg_size;
+	struct epoll_event *epoll_events;
+	int epoll_events_size;
+#endif
 };
 
 /* Function prototypes */
 
 static int          _poll_internal(struct pollfd *pfds, unsigned int nfds,
 				   time_t shutdown_time);
-static unsigned int _poll_setup_pollfds(struct pollfd *, eio_obj_t **, List);
+static unsigned int _poll_setup_pollfds(eio_handle_t *eio, struct pollfd *,
+					eio_obj_t **, unsigned int);
 static void         _poll_dispatch(struct pollfd *, unsigned int, eio_obj_t **,
 		                   List objList);
 static void         _poll_handle_event(short revents, eio_obj_t *obj,
@@ -105,6 +150,7 @@ static void         _poll_handle_event(short revents, eio_obj_t *obj,
 eio_handle_t *eio_handle_create(uint16_t shutdown_wait)
 {
 	eio_handle_t *eio = xmalloc(sizeof(*eio));
+	char *backend;
 
 	if (pipe(eio->fds) < 0) {
 		error("%s: pipe: %m", __func__);
@@ -126,6 +172,18 @@ eio_handle_t *eio_handle_create(uint16_t shutdown_wait)
 	if (shutdown_wait > 0)
 		eio->shutdown_wait = shutdown_wait;
 
+	eio->backend = EIO_BACKEND_POLL;
+	if ((backend = getenv("SLURM_EIO_BACKEND"))) {
+		if (!xstrcasecmp(backend, "epoll"))
+			eio->backend = EIO_BACKEND_EPOLL;
+		else if (xstrcasecmp(backend, "poll"))
+			error("%s: invalid SLURM_EIO_BACKEND %s",
+			      __func__, backend);
+	}
+#ifdef EIO_HAVE_EPOLL
+	eio->epfd = -1;
+#endif
+
 	return eio;
 }
 
@@ -138,6 +196,13 @@ void eio_handle_destroy(eio_handle_t *eio)
 	FREE_NULL_LIST(eio->obj_list);
 	FREE_NULL_LIST(eio->new_objs);
 	slurm_mutex_destroy(&eio->shutdown_mutex);
+#ifdef EIO_HAVE_EPOLL
+	if (eio->epfd >= 0)
+		close(eio->epfd);
+	xfree(eio->epoll_fd);
+	xfree(eio->epoll_reg);
+	xfree(eio->epoll_events);
+#endif
 
 	xassert((eio->magic = ~EIO_MAGIC));
 	xfree(eio);
@@ -281,13 +346,203 @@ static int _eio_wakeup_handler(eio_handle_t *eio)
 	return 0;
 }
 
+#ifdef EIO_HAVE_EPOLL
+/*
+ * Decide whether the handle should watch its objects through epoll,
+ * creating the epoll instance on first use.
+ * IN nobjs - number of objects in the handle
+ */
+static bool _epoll_enable(eio_handle_t *eio, unsigned int nobjs)
+{
+	if (eio->epfd >= 0)
+		return true;
+	if (eio->backend != EIO_BACKEND_EPOLL)
+		return false;
+
+	if ((eio->epfd = epoll_create1(EPOLL_CLOEXEC)) < 0) {
+		error("%s: epoll_create1: %m", __func__);
+		eio->backend = EIO_BACKEND_POLL;
+		return false;
+	}
+	debug2("%s: watching %u objects with epoll", __func__, nobjs);
+
+	return true;
+}
+
+static uint32_t _epoll_events(short events)
+{
+	uint32_t ev = 0;
+
+	if (events & POLLIN)
+		ev |= EPOLLIN;
+	if (events & POLLOUT)
+		ev |= EPOLLOUT;
+	if (events & POLLHUP)
+		ev |= EPOLLHUP;
+	if (events & POLLRDHUP)
+		ev |= EPOLLRDHUP;
+
+	return ev;
+}
+
+static short _epoll_revents(uint32_t ev)
+{
+	short revents = 0;
+
+	if (ev & EPOLLIN)
+		revents |= POLLIN;
+	if (ev & EPOLLOUT)
+		revents |= POLLOUT;
+	if (ev & EPOLLERR)
+		revents |= POLLERR;
+	if (ev & EPOLLHUP)
+		revents |= POLLHUP;
+	if (ev & EPOLLRDHUP)
+		revents |= POLLRDHUP;
+
+	return revents;
+}
+
+/*
+ * Watch obj's fd for events through epoll during the current iteration,
+ * updating its registration only if the events changed.
+ * RET true if the fd is watched with epoll, false if it must be polled
+ */
+static bool _epoll_watch(eio_handle_t *eio, eio_obj_t *obj, short events)
+{
+	eio_epoll_fd_t *ent;
+	struct epoll_event ev;
+	int fd = obj->fd, rc = -1;
+	bool registered;
+
+	if (fd < 0)
+		return false;
+
+	if (fd >= eio->epoll_fd_size) {
+		eio->epoll_fd_size = MAX(fd + 1, eio->epoll_fd_size * 2);
+		xrealloc(eio->epoll_fd,
+			 eio->epoll_fd_size * sizeof(eio_epoll_fd_t));
+	}
+	ent = &eio->epoll_fd[fd];
+
+	/* Another object already uses this fd, let poll() sort it out */
+	if (ent->iter == eio->epoll_iter)
+		return false;
+	ent->iter = eio->epoll_iter;
+	/*
+	 * A new object on this fd number has a new file, the kernel dropped
+	 * the registration of the previous one when it was closed. The id is
+	 * compared as a new object may be allocated at a freed one's address.
+	 */
+	if ((ent->obj != obj) || (ent->obj_id != obj->id)) {
+		ent->obj = obj;
+		ent->obj_id = obj->id;
+		ent->events = 0;
+		ent->no_epoll = false;
+	}
+	if (ent->no_epoll)
+		return false;
+
+	ev.events = _epoll_events(events);
+	ev.data.u64 = 0;
+	ev.data.fd = fd;
+	if (ent->events == ev.events)
+		return true;
+
+	registered = (ent->events != 0);
+	if (registered)
+		rc = epoll_ctl(eio->epfd, EPOLL_CTL_MOD, fd, &ev);
+	/* A registration is dropped if the fd was closed and reopened */
+	if (!registered || ((rc < 0) && (errno == ENOENT)))
+		rc = epoll_ctl(eio->epfd, EPOLL_CTL_ADD, fd, &ev);
+	if ((rc < 0) && (errno == EEXIST))
+		rc = epoll_ctl(eio->epfd, EPOLL_CTL_MOD, fd, &ev);
+	if (rc < 0) {
+		if (errno != EPERM)
+			debug("%s: epoll_ctl(%d): %m", __func__, fd);
+		ent->no_epoll = true;
+		ent->events = 0;
+		return false;
+	}
+
+	if (!ent->in_reg) {
+		if (eio->epoll_reg_cnt >= eio->epoll_reg_size) {
+			eio->epoll_reg_size = MAX(64, eio->epoll_reg_size * 2);
+			xrealloc(eio->epoll_reg,
+				 eio->epoll_reg_size * sizeof(int));
+		}
+		eio->epoll_reg[eio->epoll_reg_cnt++] = fd;
+		ent->in_reg = true;
+	}
+	ent->events = ev.events;
+
+	return true;
+}
+
+/*
+ * Drop the epoll registrations of fds no object watched during the
+ * current iteration.
+ */
+static void _epoll_prune(eio_handle_t *eio)
+{
+	eio_epoll_fd_t *ent;
+	int i = 0, fd;
+
+	while (i < eio->epoll_reg_cnt) {
+		fd = eio->epoll_reg[i];
+		ent = &eio->epoll_fd[fd];
+		if ((ent->iter == eio->epoll_iter) && ent->events) {
+			i++;
+			continue;
+		}
+		/* Fails harmlessly if the fd is already closed */
+		if (ent->events)
+			(void) epoll_ctl(eio->epfd, EPOLL_CTL_DEL, fd, NULL);
+		ent->events = 0;
+		ent->in_reg = false;
+		eio->epoll_reg[i] = eio->epoll_reg[--eio->epoll_reg_cnt];
+	}
+}
+
+/* Handle the events of the objects registered with epoll */
+static void _epoll_dispatch(eio_handle_t *eio)
+{
+	eio_epoll_fd_t *ent;
+	int i, n, fd;
+
+	if (eio->epoll_events_size < eio->epoll_reg_cnt) {
+		eio->epoll_events_size = eio->epoll_reg_cnt;
+		xrealloc(eio->epoll_events, eio->epoll_events_size *
+					    sizeof(struct epoll_event));
+	}
+
+	while ((n = epoll_wait(eio->epfd, eio->epoll_events,
+			       eio->epoll_events_size, 0)) < 0) {
+		if (errno != EINTR) {
+			error("%s: epoll_wait: %m", __func__);
+			return;
+		}
+	}
+
+	for (i = 0; i < n; i++) {
+		fd = eio->epoll_events[i].data.fd;
+		ent = &eio->epoll_fd[fd];
+		if (ent->iter != eio->epoll_iter)
+			continue;
+		_poll_handle_event(_epoll_revents(eio->epoll_events[i].events),
+				   ent->obj, eio->obj_list);
+	}
+}
+#endif
+
 int eio_handle_mainloop(eio_handle_t *eio)
 {
 	int            retval  = 0;
 	struct pollfd *pollfds = NULL;
 	eio_obj_t    **map     = NULL;
-	unsigned int   maxnfds = 0, nfds = 0;
+	unsigned int   maxnfds = 0, nfds = 0, obj_nfds = 0;
 	unsigned int   n       = 0;
+	int epoll_inx;
 	time_t shutdown_time;
 
 	xassert (eio != NULL);
@@ -298,7 +553,7 @@ int eio_handle_mainloop(eio_handle_t *eio)
 		n = list_count(eio->obj_list);
 		if (maxnfds < n) {
 			maxnfds = n;
-			xrealloc(pollfds, (maxnfds+1) * sizeof(struct pollfd));
+			xrealloc(pollfds, (maxnfds+2) * sizeof(struct pollfd));
 			xrealloc(map, maxnfds * sizeof(eio_obj_t *));
 			/*
 			 * Note: xrealloc() also handles initial malloc
@@ -309,7 +564,23 @@ int eio_handle_mainloop(eio_handle_t *eio)
 
 		debug4("eio: handling events for %d objects",
 		       list_count(eio->obj_list));
-		nfds = _poll_setup_pollfds(pollfds, map, eio->obj_list);
+		epoll_inx = -1;
+#ifdef EIO_HAVE_EPOLL
+		if (_epoll_enable(eio, n) && !++eio->epoll_iter)
+			eio->epoll_iter = 1;	/* 0 marks fds never watched */
+#endif
+		nfds = obj_nfds = _poll_setup_pollfds(eio, pollfds, map,
+						      maxnfds);
+#ifdef EIO_HAVE_EPOLL
+		if (eio->epfd >= 0) {
+			_epoll_prune(eio);
+			if (eio->epoll_reg_cnt) {
+				pollfds[nfds].fd     = eio->epfd;
+				pollfds[nfds].events = POLLIN;
+				epoll_inx = nfds++;
+			}
+		}
+#endif
 		if (nfds <= 0)
 			goto done;
 
@@ -320,7 +591,7 @@ int eio_handle_mainloop(eio_handle_t *eio)
 		pollfds[nfds].events = POLLIN;
 		nfds++;
 
-		xassert(nfds <= maxnfds + 1);
+		xassert(nfds <= maxnfds + 2);
 
 		/* Get shutdown_time to pass to _poll_internal */
 		slurm_mutex_lock(&eio->shutdown_mutex);
@@ -333,7 +604,11 @@ int eio_handle_mainloop(eio_handle_t *eio)
 		if (pollfds[nfds-1].revents & POLLIN)
 			_eio_wakeup_handler(eio);
 
-		_poll_dispatch(pollfds, nfds - 1, map, eio->obj_list);
+		_poll_dispatch(pollfds, obj_nfds, map, eio->obj_list);
+#ifdef EIO_HAVE_EPOLL
+		if ((epoll_inx >= 0) && (pollfds[epoll_inx].revents & POLLIN))
+			_epoll_dispatch(eio);
+#endif
 
 		slurm_mutex_lock(&eio->shutdown_mutex);
 		shutdown_time = eio->shutdown_time;
@@ -388,42 +663,91 @@ static bool _is_readable(eio_obj_t *obj)
 	return (obj->ops->readable && (*obj->ops->readable)(obj));
 }
 
-static unsigned int _poll_setup_pollfds(struct pollfd *pfds, eio_obj_t *map[],
-					List l)
+typedef struct {
+	eio_handle_t *eio;
+	struct pollfd *pfds;
+	eio_obj_t **map;
+	unsigned int nfds;
+} poll_setup_args_t;
+
+static void _poll_setup_obj(eio_obj_t *obj, poll_setup_args_t *args)
 {
-	ListIterator  i    = list_iterator_create(l);
-	eio_obj_t    *obj  = NULL;
-	unsigned int  nfds = 0;
-	bool          readable, writable;
+	bool readable, writable;
+	short events;
+
+	writable = _is_writable(obj);
+	readable = _is_readable(obj);
+	if (writable && readable)
+		events = POLLOUT | POLLIN | POLLHUP | POLLRDHUP;
+	else if (readable)
+		events = POLLIN | POLLRDHUP;
+	else if (writable)
+		events = POLLOUT | POLLHUP;
+	else
+		return;
+#ifdef EIO_HAVE_EPOLL
+	if ((args->eio->epfd >= 0) && _epoll_watch(args->eio, obj, events))
+		return;
+#endif
+	args->pfds[args->nfds].fd     = obj->fd;
+	args->pfds[args->nfds].events = events;
+	args->map[args->nfds]         = obj;
+	args->nfds++;
+}
+
+typedef struct {
+	eio_obj_t **map;
+	unsigned int cnt;
+	unsigned int size;
+} obj_snapshot_t;
+
+static int _snapshot_obj(void *x, void *arg)
+{
+	obj_snapshot_t *snap = (obj_snapshot_t *) arg;
+
+	if (snap->cnt >= snap->size)
+		return -1;
+	snap->map[snap->cnt++] = (eio_obj_t *) x;
+	return 0;
+}
+
+/*
+ * Set up the pollfd entries of the objects which are readable or writable.
+ * With epoll in use only the objects epoll can not watch get an entry.
+ *
+ * The object pointers are first copied into map[] with list_for_each(), so
+ * the list lock is taken once per loop iteration rather than once per
+ * object. The readable() and writable() callbacks then run with the list
+ * unlocked, as they may add objects (e.g. with eio_new_obj()). map[] is
+ * compacted in place to the objects which got a pollfd entry.
+ */
+static unsigned int _poll_setup_pollfds(eio_handle_t *eio,
+					struct pollfd *pfds, eio_obj_t *map[],
+					unsigned int map_size)
+{
+	obj_snapshot_t snap;
+	poll_setup_args_t args;
+	unsigned int i;
 
 	if (!pfds) {	/* Fix for CLANG false positive */
 		fatal("%s: pollfd data structure is null", __func__);
-		return nfds;
+		return 0;
 	}
 
-	while ((obj = list_next(i))) {
-		writable = _is_writable(obj);
-		readable = _is_readable(obj);
-		if (writable && readable) {
-			pfds[nfds].fd     = obj->fd;
-			pfds[nfds].events = POLLOUT | POLLIN |
-					    POLLHUP | POLLRDHUP;
-			map[nfds]         = obj;
-			nfds++;
-		} else if (readable) {
-			pfds[nfds].fd     = obj->fd;
-			pfds[nfds].events = POLLIN | POLLRDHUP;
-			map[nfds]         = obj;
-			nfds++;
-		} else if (writable) {
-			pfds[nfds].fd     = obj->fd;
-			pfds[nfds].events = POLLOUT | POLLHUP;
-			map[nfds]         = obj;
-			nfds++;
-		}
-	}
-	list_iterator_destroy(i);
-	return nfds;
+	snap.map = map;
+	snap.cnt = 0;
+	snap.size = map_size;
+	(void) list_for_each(eio->obj_list, _snapshot_obj, &snap);
+
+	args.eio = eio;
+	args.pfds = pfds;
+	args.map = map;
+	args.nfds = 0;
+	/* args.nfds <= i, so map[i] is read before it can be overwritten */
+	for (i = 0; i < snap.cnt; i++)
+		_poll_setup_obj(map[i], &args);
+
+	return args.nfds;
 }
 
 static void _poll_dispatch(struct pollfd *pfds, unsigned int nfds,
@@ -511,7 +835,15 @@ static struct io_operations *_ops_copy(struct io_operations *ops)
 
 eio_obj_t *eio_obj_create(int fd, struct io_operations *ops, void *arg)
 {
+	static pthread_mutex_t id_mutex = PTHREAD_MUTEX_INITIALIZER;
+	static uint32_t next_id = 0;
 	eio_obj_t *obj = xmalloc(sizeof(*obj));
+
+	slurm_mutex_lock(&id_mutex);
+	if (!++next_id)
+		next_id = 1;	/* 0 marks an epoll entry never used */
+	obj->id  = next_id;
+	slurm_mutex_unlock(&id_mutex);
 	obj->fd  = fd;
 	obj->arg = arg;
 	obj->ops = _ops_copy(ops);
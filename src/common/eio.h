@@ -67,6 +67,7 @@ struct eio_obj {
 	void *arg;                        /* application-specific data       */
 	struct io_operations *ops;        /* pointer to ops struct for obj   */
 	bool shutdown;
+	uint32_t id;                      /* set by eio_obj_create()         */
 };
 
 eio_handle_t *eio_handle_create(uint16_t);
@@ -100,6 +101,10 @@ bool eio_remove_obj(eio_obj_t *obj, List objs);
  * This routine will watch for activity on the fd's as long
  * as obj->readable() or obj->writable() returns >0
  *
+ * The fd's are watched with poll(), or with epoll (where available) if the
+ * SLURM_EIO_BACKEND environment variable is set to "epoll" when the handle
+ * is created.
+ *
  * routine returns 0 when either list is empty or no objects in list are
  * readable() or writable().
  *
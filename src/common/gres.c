@@ -6096,9 +6096,14 @@ static void	_job_core_filter(void *job_gres_data, void *node_gres_data,
 		use_busy_dev = true;
 	}
 
-	/* Determine which specific cores can be used */
-	avail_core_bitmap = bit_copy(core_bitmap);
-	bit_nclear(avail_core_bitmap, core_start_bit, core_end_bit);
+	/*
+	 * Determine which specific cores can be used. Work with a bitmap of
+	 * just this node's cores rather than a copy of the system-wide one.
+	 */
+	core_ctld = core_end_bit - core_start_bit + 1;
+	if (core_ctld < 1)
+		return;
+	avail_core_bitmap = bit_alloc(core_ctld);
 	for (i = 0; i < node_gres_ptr->topo_cnt; i++) {
 		if (node_gres_ptr->topo_gres_cnt_avail[i] == 0)
 			continue;
@@ -6117,26 +6122,42 @@ static void	_job_core_filter(void *job_gres_data, void *node_gres_data,
 			FREE_NULL_BITMAP(avail_core_bitmap);	/* No filter */
 			return;
 		}
-		core_ctld = core_end_bit - core_start_bit + 1;
 		_validate_gres_node_cores(node_gres_ptr, core_ctld, node_name);
-		core_ctld = bit_size(node_gres_ptr->topo_core_bitmap[i]);
-		for (j = 0; j < core_ctld; j++) {
-			if (bit_test(node_gres_ptr->topo_core_bitmap[i], j)) {
-				bit_set(avail_core_bitmap, core_start_bit + j);
-			}
-		}
+		bit_or(avail_core_bitmap, node_gres_ptr->topo_core_bitmap[i]);
+	}
+	for (j = 0; j < core_ctld; j++) {
+		if (!bit_test(avail_core_bitmap, j))
+			bit_clear(core_bitmap, core_start_bit + j);
 	}
-	bit_and(core_bitmap, avail_core_bitmap);
 	FREE_NULL_BITMAP(avail_core_bitmap);
 }
 
+/*
+ * Copy one node's cores from a system-wide core bitmap
+ * RET bitmap of (core_end_bit - core_start_bit + 1) bits, caller must free
+ */
+static bitstr_t *_node_core_bitmap(bitstr_t *core_bitmap, int core_start_bit,
+				   int core_end_bit)
+{
+	bitstr_t *node_core_bitmap;
+	int i;
+
+	node_core_bitmap = bit_alloc(core_end_bit - core_start_bit + 1);
+	for (i = core_start_bit; i <= core_end_bit; i++) {
+		if (bit_test(core_bitmap, i))
+			bit_set(node_core_bitmap, i - core_start_bit);
+	}
+
+	return node_core_bitmap;
+}
+
 static uint32_t _job_test(void *job_gres_data, void *node_gres_data,
 			  bool use_total_gres, bitstr_t *core_bitmap,
 			  int core_start_bit, int core_end_bit, bool *topo_set,
 			  uint32_t job_id, char *node_name, char *gres_name,
 			  uint32_t plugin_id)
 {
-	int i, j, core_size, core_ctld, top_inx = -1;
+	int i, j, core_ctld, top_inx = -1;
 	uint64_t gres_avail = 0, gres_max = 0, gres_total, gres_tmp;
 	gres_job_state_t  *job_gres_ptr  = (gres_job_state_t *)  job_gres_data;
 	gres_node_state_t *node_gres_ptr = (gres_node_state_t *) node_gres_data;
@@ -6173,6 +6194,9 @@ static uint32_t _job_test(void *job_gres_data, void *node_gres_data,
 			}
 			_validate_gres_node_cores(node_gres_ptr, core_ctld,
 						  node_name);
+			avail_core_bitmap = _node_core_bitmap(core_bitmap,
+							      core_start_bit,
+							      core_end_bit);
 		}
 		for (i = 0; i < node_gres_ptr->topo_cnt; i++) {
 			if (job_gres_ptr->type_name &&
@@ -6194,26 +6218,24 @@ static uint32_t _job_test(void *job_gres_data, void *node_gres_data,
 					gres_max = MAX(gres_max, gres_avail);
 				continue;
 			}
-			core_ctld = bit_size(node_gres_ptr->
-					     topo_core_bitmap[i]);
-			for (j = 0; j < core_ctld; j++) {
-				if (core_bitmap &&
-				    !bit_test(core_bitmap, core_start_bit + j))
-					continue;
-				if (!bit_test(node_gres_ptr->
-					      topo_core_bitmap[i], j))
+			if (avail_core_bitmap) {
+				if (!bit_overlap(avail_core_bitmap,
+						 node_gres_ptr->
+						 topo_core_bitmap[i]))
 					continue; /* not avail for this gres */
-				gres_avail += node_gres_ptr->
-					      topo_gres_cnt_avail[i];
-				if (!use_total_gres) {
-					gres_avail -= node_gres_ptr->
-						      topo_gres_cnt_alloc[i];
-				}
-				if (shared_gres)
-					gres_max = MAX(gres_max, gres_avail);
-				break;
+			} else if (bit_ffs(node_gres_ptr->
+					   topo_core_bitmap[i]) < 0) {
+				continue;	/* not avail for this gres */
 			}
+			gres_avail += node_gres_ptr->topo_gres_cnt_avail[i];
+			if (!use_total_gres) {
+				gres_avail -= node_gres_ptr->
+					      topo_gres_cnt_alloc[i];
+			}
+			if (shared_gres)
+				gres_max = MAX(gres_max, gres_avail);
 		}
+		FREE_NULL_BITMAP(avail_core_bitmap);
 		if (shared_gres)
 			gres_avail = gres_max;
 		if (job_gres_ptr->gres_per_node > gres_avail)
@@ -6246,13 +6268,12 @@ static uint32_t _job_test(void *job_gres_data, void *node_gres_data,
 			}
 		}
 
-		alloc_core_bitmap = bit_alloc(core_ctld);
 		if (core_bitmap) {
-			for (j = 0; j < core_ctld; j++) {
-				if (bit_test(core_bitmap, core_start_bit + j))
-					bit_set(alloc_core_bitmap, j);
-			}
+			alloc_core_bitmap = _node_core_bitmap(core_bitmap,
+							      core_start_bit,
+							      core_end_bit);
 		} else {
+			alloc_core_bitmap = bit_alloc(core_ctld);
 			bit_nset(alloc_core_bitmap, 0, core_ctld - 1);
 		}
 
@@ -6281,15 +6302,13 @@ static uint32_t _job_test(void *job_gres_data, void *node_gres_data,
 						 core_start_bit + 1;
 				continue;
 			}
-			core_size = bit_size(node_gres_ptr->topo_core_bitmap[i]);
-			for (j = 0; j < core_size; j++) {
-				if (core_bitmap &&
-				    !bit_test(core_bitmap, core_start_bit + j))
-					continue;
-				if (bit_test(node_gres_ptr->
-					     topo_core_bitmap[i], j)) {
-					cores_avail[i]++;
-				}
+			if (core_bitmap) {
+				cores_avail[i] = bit_overlap(avail_core_bitmap,
+							     node_gres_ptr->
+							     topo_core_bitmap[i]);
+			} else {
+				cores_avail[i] = bit_set_count(node_gres_ptr->
+							       topo_core_bitmap[i]);
 			}
 		}
 
@@ -42,6 +42,7 @@
 
 #include <dirent.h>
 #include <inttypes.h>
+#include <pthread.h>
 #include <regex.h>
 #include <signal.h>
 #include <stdlib.h>
@@ -74,6 +75,24 @@ strong_alias(stepd_get_uid, slurm_stepd_get_uid);
 strong_alias(stepd_add_extern_pid, slurm_stepd_add_extern_pid);
 strong_alias(stepd_get_x11_display, slurm_stepd_get_x11_display);
 
+/*
+ * The last stepd_available() scan. slurmd scans the spool directory several
+ * times for most job RPCs, so the scan is reused for as long as the
+ * directory's modification time is unchanged.
+ */
+typedef struct {
+	uint32_t jobid;
+	uint32_t stepid;
+} step_cache_t;
+
+static pthread_mutex_t step_cache_mutex = PTHREAD_MUTEX_INITIALIZER;
+static bool step_cache_valid = false;
+static char *step_cache_dir = NULL;
+static char *step_cache_node = NULL;
+static time_t step_cache_mtime = 0;
+static step_cache_t *step_cache = NULL;
+static int step_cache_cnt = 0;
+
 static bool
 _slurm_authorized_user()
 {
@@ -609,6 +628,74 @@ _sockname_regex(regex_t *re, const char *filename,
 	return 0;
 }
 
+static void _step_loc_add(List l, const char *directory,
+			  const char *nodename, uint32_t jobid,
+			  uint32_t stepid)
+{
+	step_loc_t *loc;
+
+	debug4("found jobid = %u, stepid = %u", jobid, stepid);
+	loc = xmalloc(sizeof(step_loc_t));
+	loc->directory = xstrdup(directory);
+	loc->nodename = xstrdup(nodename);
+	loc->jobid = jobid;
+	loc->stepid = stepid;
+	list_append(l, (void *)loc);
+}
+
+/*
+ * Fill "l" from the cached scan if it is of the same directory and
+ * nodename and the directory has not been modified since.
+ * RET true if the cached scan was used
+ */
+static bool _step_cache_load(List l, const char *directory,
+			     const char *nodename, time_t mtime)
+{
+	bool found = false;
+	int i;
+
+	slurm_mutex_lock(&step_cache_mutex);
+	if (step_cache_valid && (step_cache_mtime == mtime) &&
+	    !xstrcmp(step_cache_dir, directory) &&
+	    !xstrcmp(step_cache_node, nodename)) {
+		for (i = 0; i < step_cache_cnt; i++) {
+			_step_loc_add(l, directory, nodename,
+				      step_cache[i].jobid,
+				      step_cache[i].stepid);
+		}
+		found = true;
+	}
+	slurm_mutex_unlock(&step_cache_mutex);
+
+	return found;
+}
+
+static void _step_cache_save(List l, const char *directory,
+			     const char *nodename, time_t mtime)
+{
+	ListIterator itr;
+	step_loc_t *loc;
+	int i = 0;
+
+	slurm_mutex_lock(&step_cache_mutex);
+	xfree(step_cache_dir);
+	xfree(step_cache_node);
+	step_cache_dir = xstrdup(directory);
+	step_cache_node = xstrdup(nodename);
+	step_cache_mtime = mtime;
+	step_cache_cnt = list_count(l);
+	xrealloc(step_cache, sizeof(step_cache_t) * (step_cache_cnt + 1));
+	itr = list_iterator_create(l);
+	while ((loc = list_next(itr))) {
+		step_cache[i].jobid = loc->jobid;
+		step_cache[i].stepid = loc->stepid;
+		i++;
+	}
+	list_iterator_destroy(itr);
+	step_cache_valid = true;
+	slurm_mutex_unlock(&step_cache_mutex);
+}
+
 /*
  * Scan for available running slurm step daemons by checking
  * "directory" for unix domain sockets with names beginning in "nodename".
@@ -628,6 +715,7 @@ stepd_available(const char *directory, const char *nodename)
 	struct dirent *ent;
 	regex_t re;
 	struct stat stat_buf;
+	time_t now;
 
 	if (nodename == NULL) {
 		if (!(nodename = _guess_nodename())) {
@@ -645,41 +733,45 @@ stepd_available(const char *directory, const char *nodename)
 	}
 
 	l = list_create((ListDelF) _free_step_loc_t);
-	if (_sockname_regex_init(&re, nodename) == -1)
-		goto done;
+	now = time(NULL);
 
 	/*
 	 * Make sure that "directory" exists and is a directory.
 	 */
 	if (stat(directory, &stat_buf) < 0) {
 		error("Domain socket directory %s: %m", directory);
-		goto done;
+		return l;
 	} else if (!S_ISDIR(stat_buf.st_mode)) {
 		error("%s is not a directory", directory);
-		goto done;
+		return l;
 	}
 
+	if (_step_cache_load(l, directory, nodename, stat_buf.st_mtime))
+		return l;
+
+	if (_sockname_regex_init(&re, nodename) == -1)
+		goto done;
+
 	if ((dp = opendir(directory)) == NULL) {
 		error("Unable to open directory: %m");
 		goto done;
 	}
 
 	while ((ent = readdir(dp)) != NULL) {
-		step_loc_t *loc;
 		uint32_t jobid, stepid;
 
-		if (_sockname_regex(&re, ent->d_name, &jobid, &stepid) == 0) {
-			debug4("found jobid = %u, stepid = %u", jobid, stepid);
-			loc = xmalloc(sizeof(step_loc_t));
-			loc->directory = xstrdup(directory);
-			loc->nodename = xstrdup(nodename);
-			loc->jobid = jobid;
-			loc->stepid = stepid;
-			list_append(l, (void *)loc);
-		}
+		if (_sockname_regex(&re, ent->d_name, &jobid, &stepid) == 0)
+			_step_loc_add(l, directory, nodename, jobid, stepid);
 	}
 
 	closedir(dp);
+
+	/*
+	 * A socket created or removed within the second of the stat() might
+	 * not change the modification time, so only cache older directories.
+	 */
+	if (stat_buf.st_mtime < (now - 1))
+		_step_cache_save(l, directory, nodename, stat_buf.st_mtime);
 done:
 	regfree(&re);
 	return l;
@@ -94,13 +94,48 @@ const char plugin_name[] = "Job accounting gather cgroup plugin";
 const char plugin_type[] = "jobacct_gather/cgroup";
 const uint32_t plugin_version = SLURM_VERSION_NUMBER;
 
+/*
+ * Read a task cgroup counter file through the descriptor kept open in
+ * task_cg, opening it on first use. A kept descriptor that fails to read is
+ * reopened once in case the cgroup was recreated.
+ * RET bytes read or -1
+ */
+static int _read_task_cg_file(task_cg_info_t *task_cg, char *param,
+			      char *buf, int size)
+{
+	char file_path[PATH_MAX];
+	bool reopen = (task_cg->stat_fd >= 0);
+	int n;
+
+	while (1) {
+		if (task_cg->stat_fd < 0) {
+			if (snprintf(file_path, PATH_MAX, "%s/%s",
+				     task_cg->task_cg.path, param) >= PATH_MAX)
+				return -1;
+			task_cg->stat_fd = open(file_path,
+						O_RDONLY | O_CLOEXEC);
+			if (task_cg->stat_fd < 0)
+				return -1;
+		}
+		n = pread(task_cg->stat_fd, buf, size - 1, 0);
+		if (n > 0) {
+			buf[n] = '\0';
+			return n;
+		}
+		close(task_cg->stat_fd);
+		task_cg->stat_fd = -1;
+		if (!reopen)
+			return -1;
+		reopen = false;
+	}
+}
+
 static void _prec_extra(jag_prec_t *prec, uint32_t taskid)
 {
 	unsigned long utime, stime, total_rss, total_pgpgin;
-	char *cpu_time = NULL, *memory_stat = NULL, *ptr;
-	size_t cpu_time_size = 0, memory_stat_size = 0;
-	xcgroup_t *task_cpuacct_cg = NULL;;
-	xcgroup_t *task_memory_cg = NULL;
+	char cpu_time[256], memory_stat[8192], *ptr;
+	task_cg_info_t *task_cpuacct_cg = NULL;
+	task_cg_info_t *task_memory_cg = NULL;
 	bool exit_early = false;
 
 	/* Find which task cgroups to use */
@@ -132,9 +167,8 @@ static void _prec_extra(jag_prec_t *prec, uint32_t taskid)
 	//START_TIMER;
 	/* info("before"); */
 	/* print_jag_prec(prec); */
-	xcgroup_get_param(task_cpuacct_cg, "cpuacct.stat",
-			  &cpu_time, &cpu_time_size);
-	if (cpu_time == NULL) {
+	if (_read_task_cg_file(task_cpuacct_cg, "cpuacct.stat",
+			       cpu_time, sizeof(cpu_time)) < 0) {
 		debug2("%s: failed to collect cpuacct.stat pid %d ppid %d",
 		       __func__, prec->pid, prec->ppid);
 	} else {
@@ -147,9 +181,8 @@ static void _prec_extra(jag_prec_t *prec, uint32_t taskid)
 		prec->ssec = stime;
 	}
 
-	xcgroup_get_param(task_memory_cg, "memory.stat",
-			  &memory_stat, &memory_stat_size);
-	if (memory_stat == NULL) {
+	if (_read_task_cg_file(task_memory_cg, "memory.stat",
+			       memory_stat, sizeof(memory_stat)) < 0) {
 		debug2("%s: failed to collect memory.stat  pid %d ppid %d",
 		       __func__, prec->pid, prec->ppid);
 	} else {
@@ -175,9 +208,6 @@ static void _prec_extra(jag_prec_t *prec, uint32_t taskid)
 		}
 	}
 
-	xfree(cpu_time);
-	xfree(memory_stat);
-
 	/* FIXME: Enable when kernel support ready.
 	 *
 	 * "Read" and "Write" from blkio.throttle.io_service_bytes are
@@ -310,6 +340,11 @@ extern void jobacct_gather_p_poll_data(
 		memset(&callbacks, 0, sizeof(jag_callbacks_t));
 		first = 0;
 		callbacks.prec_extra = _prec_extra;
+		/*
+		 * The task cgroups account for all of a task's processes, so
+		 * only the task processes themselves are read from /proc.
+		 */
+		callbacks.get_precs = jag_common_get_task_precs;
 	}
 
 	jag_common_poll_data(task_list, pgid_plugin, cont_id, &callbacks,
@@ -403,6 +438,8 @@ extern void free_task_cg_info(void *object)
 	task_cg_info_t *task_cg = (task_cg_info_t *)object;
 
 	if (task_cg) {
+		if (task_cg->stat_fd >= 0)
+			close(task_cg->stat_fd);
 		xcgroup_destroy(&task_cg->task_cg);
 		xfree(task_cg);
 	}
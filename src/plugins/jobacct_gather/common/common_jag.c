@@ -78,6 +78,21 @@ static DIR  *slash_proc = NULL;
 static int energy_profile = ENERGY_DATA_NODE_ENERGY_UP;
 static uint64_t debug_flags = 0;
 
+/*
+ * Open /proc files of the processes in the proctrack container, kept between
+ * polls and read again with pread(). Sorted by pid.
+ */
+#define PROC_FD_MAX 256
+typedef struct {
+	pid_t pid;
+	int stat_fd;
+	int io_fd;
+	int lwp;	/* _is_a_lwp() result, -1 if not known yet */
+} proc_fd_t;
+
+static proc_fd_t *proc_fd = NULL;
+static int proc_fd_cnt = 0;
+
 static int _find_prec(void *x, void *key)
 {
 	jag_prec_t *prec = (jag_prec_t *) x;
@@ -306,7 +321,7 @@ again:
 
 /* _get_process_data_line() - get line of data from /proc/<pid>/stat
  *
- * IN:	in - input file descriptor
+ * IN:	sbuf - contents of the file
  * OUT:	prec - the destination for the data
  *
  * RETVAL:	==0 - no valid data
@@ -314,24 +329,14 @@ again:
  *
  * Based upon stat2proc() from the ps command. It can handle arbitrary
  * executable file basenames for `cmd', i.e. those with embedded whitespace or
- * embedded ')'s. Such names confuse %s (see scanf(3)), so the string is split
- * and %39c is used instead. (except for embedded ')' "(%[^)]c)" would work.
+ * embedded ')'s, by splitting at the last ')'. The numeric fields after the
+ * state are read with strtoll() rather than sscanf() as this is called for
+ * every process on every poll.
  */
-static int _get_process_data_line(int in, jag_prec_t *prec) {
-	char sbuf[512], *tmp;
-	int num_read, nvals;
-	char cmd[40], state[1];
-	int ppid, pgrp, session, tty_nr, tpgid;
-	long unsigned flags, minflt, cminflt, majflt, cmajflt;
-	long unsigned utime, stime, starttime, vsize;
-	long int cutime, cstime, priority, nice, timeout, itrealvalue, rss;
-	long unsigned f1, f2, f3, f4, f5, f6, f7, f8, f9, f10, f11, f12, f13;
-	int exit_signal, last_cpu;
-
-	num_read = read(in, sbuf, (sizeof(sbuf) - 1));
-	if (num_read <= 0)
-		return 0;
-	sbuf[num_read] = '\0';
+static int _get_process_data_line(char *sbuf, jag_prec_t *prec) {
+	char *tmp, *end;
+	long long val[37];
+	int nvals;
 
 	/*
 	 * split into "PID (cmd" and "<rest>" replace trailing ')' with NULL
@@ -341,48 +346,43 @@ static int _get_process_data_line(int in, jag_prec_t *prec) {
 		return 0;
 	*tmp = '\0';
 
-	/* parse these two strings separately, skipping the leading "(". */
-	nvals = sscanf(sbuf, "%d (%39c", &prec->pid, cmd);
-	if (nvals < 2)
+	prec->pid = strtol(sbuf, &end, 10);
+	if ((end == sbuf) || (end[0] != ' ') || (end[1] != '('))
 		return 0;
 
-	nvals = sscanf(tmp + 2,	 /* skip space after ')' too */
-		       "%c %d %d %d %d %d "
-		       "%lu %lu %lu %lu %lu "
-		       "%lu %lu %ld %ld %ld %ld "
-		       "%ld %ld %lu %lu %ld "
-		       "%lu %lu %lu %lu %lu "
-		       "%lu %lu %lu %lu %lu "
-		       "%lu %lu %lu %d %d ",
-		       state, &ppid, &pgrp, &session, &tty_nr, &tpgid,
-		       &flags, &minflt, &cminflt, &majflt, &cmajflt,
-		       &utime, &stime, &cutime, &cstime, &priority, &nice,
-		       &timeout, &itrealvalue, &starttime, &vsize, &rss,
-		       &f1, &f2, &f3, &f4, &f5 ,&f6, &f7, &f8, &f9, &f10, &f11,
-		       &f12, &f13, &exit_signal, &last_cpu);
-	/* There are some additional fields, which we do not scan or use */
-	if ((nvals < 37) || (rss < 0))
+	/*
+	 * Skip the space after ')' and the state. val[] is indexed as the
+	 * fields follow the state: 1 ppid, 9 majflt, 11 utime, 12 stime,
+	 * 20 vsize, 21 rss, 36 processor.
+	 */
+	tmp += 2;
+	if (*tmp == '\0')
 		return 0;
-
-	/* If current pid corresponds to a Light Weight Process (Thread POSIX) */
-	/* skip it, we will only account the original process (pid==tgid) */
-	if (_is_a_lwp(prec->pid) > 0)
+	tmp++;
+	for (nvals = 1; nvals < 37; nvals++) {
+		val[nvals] = strtoll(tmp, &end, 10);
+		if (end == tmp)
+			break;
+		tmp = end;
+	}
+	/* There are some additional fields, which we do not scan or use */
+	if ((nvals < 37) || (val[21] < 0))
 		return 0;
 
 	/* Copy the values that slurm records into our data structure */
-	prec->ppid  = ppid;
+	prec->ppid  = val[1];
 
-	prec->tres_data[TRES_ARRAY_PAGES].size_read = majflt;
-	prec->tres_data[TRES_ARRAY_VMEM].size_read = vsize;
-	prec->tres_data[TRES_ARRAY_MEM].size_read = rss * my_pagesize;
+	prec->tres_data[TRES_ARRAY_PAGES].size_read = val[9];
+	prec->tres_data[TRES_ARRAY_VMEM].size_read = val[20];
+	prec->tres_data[TRES_ARRAY_MEM].size_read = val[21] * my_pagesize;
 
 	/*
 	 * Store unnormalized times, we will normalize in when
 	 * transfering to a struct jobacctinfo in job_common_poll_data()
 	 */
-	prec->usec = (double)utime;
-	prec->ssec = (double)stime;
-	prec->last_cpu = last_cpu;
+	prec->usec = (double)val[11];
+	prec->ssec = (double)val[12];
+	prec->last_cpu = val[36];
 	return 1;
 }
 
@@ -450,7 +450,7 @@ static int _remove_share_data(char *proc_stat_file, jag_prec_t *prec)
 
 /* _get_process_io_data_line() - get line of data from /proc/<pid>/io
  *
- * IN:	in - input file descriptor
+ * IN:	sbuf - contents of the file
  * OUT:	prec - the destination for the data
  *
  * RETVAL:	==0 - no valid data
@@ -461,25 +461,16 @@ static int _remove_share_data(char *proc_stat_file, jag_prec_t *prec)
  * wrchar: <# of characters written>
  *   . . .
  */
-static int _get_process_io_data_line(int in, jag_prec_t *prec) {
-	char sbuf[256];
+static int _get_process_io_data_line(char *sbuf, jag_prec_t *prec) {
 	char f1[7], f3[7];
-	int num_read, nvals;
+	int nvals;
 	uint64_t rchar, wchar;
 
-	num_read = read(in, sbuf, (sizeof(sbuf) - 1));
-	if (num_read <= 0)
-		return 0;
-	sbuf[num_read] = '\0';
-
-	nvals = sscanf(sbuf, "%s %"PRIu64" %s %"PRIu64"",
+	nvals = sscanf(sbuf, "%6s %"PRIu64" %6s %"PRIu64"",
 		       f1, &rchar, f3, &wchar);
 	if (nvals < 4)
 		return 0;
 
-	if (_is_a_lwp(prec->pid) > 0)
-		return 0;
-
 	/* keep real value here since we aren't doubles */
 	prec->tres_data[TRES_ARRAY_FS_DISK].size_read = rchar;
 	prec->tres_data[TRES_ARRAY_FS_DISK].size_write = wchar;
@@ -487,16 +478,113 @@ static int _get_process_io_data_line(int in, jag_prec_t *prec) {
 	return 1;
 }
 
-static void _handle_stats(List prec_list, char *proc_stat_file,
-			  char *proc_io_file, char *proc_smaps_file,
+static int _proc_fd_cmp(const void *x, const void *y)
+{
+	const proc_fd_t *a = x, *b = y;
+
+	if (a->pid < b->pid)
+		return -1;
+	return (a->pid > b->pid);
+}
+
+static proc_fd_t *_proc_fd_find(pid_t pid)
+{
+	proc_fd_t key;
+
+	key.pid = pid;
+	return bsearch(&key, proc_fd, proc_fd_cnt, sizeof(proc_fd_t),
+		       _proc_fd_cmp);
+}
+
+static void _proc_fd_close(proc_fd_t *pfd)
+{
+	if (pfd->stat_fd >= 0)
+		close(pfd->stat_fd);
+	if (pfd->io_fd >= 0)
+		close(pfd->io_fd);
+	pfd->stat_fd = -1;
+	pfd->io_fd = -1;
+}
+
+/*
+ * Keep the open /proc files of "pids" and close those of processes that
+ * have left the container.
+ */
+static void _proc_fd_update(pid_t *pids, int npids)
+{
+	proc_fd_t *new_fd, *old;
+	int i, new_cnt = MIN(npids, PROC_FD_MAX);
+
+	new_fd = xmalloc(sizeof(proc_fd_t) * (new_cnt + 1));
+	for (i = 0; i < new_cnt; i++) {
+		if ((old = _proc_fd_find(pids[i])) && (old->lwp != -2)) {
+			new_fd[i] = *old;
+			old->lwp = -2;	/* moved */
+		} else {
+			new_fd[i].pid = pids[i];
+			new_fd[i].stat_fd = -1;
+			new_fd[i].io_fd = -1;
+			new_fd[i].lwp = -1;
+		}
+	}
+	for (i = 0; i < proc_fd_cnt; i++) {
+		if (proc_fd[i].lwp != -2)
+			_proc_fd_close(&proc_fd[i]);
+	}
+	xfree(proc_fd);
+	qsort(new_fd, new_cnt, sizeof(proc_fd_t), _proc_fd_cmp);
+	proc_fd = new_fd;
+	proc_fd_cnt = new_cnt;
+}
+
+/*
+ * Read /proc/<pid>/<name> into sbuf, opening it into *fd if not already
+ * open. A kept descriptor of a process that has exited fails to read, so it
+ * is reopened once in case the pid has been reused. *reopened is set if
+ * that happened, the file read may then belong to another process.
+ * RET bytes read or -1
+ */
+static int _proc_read(pid_t pid, const char *name, int *fd,
+		      char *sbuf, int size, bool *reopened)
+{
+	char path[64];
+	bool reopen = (*fd >= 0);
+	int n;
+
+	*reopened = false;
+	while (1) {
+		if (*fd < 0) {
+			snprintf(path, sizeof(path), "/proc/%d/%s",
+				 (int) pid, name);
+			if ((*fd = open(path, O_RDONLY | O_CLOEXEC)) < 0)
+				return -1;  /* Assume the process went away */
+		}
+		n = pread(*fd, sbuf, size - 1, 0);
+		if (n > 0) {
+			sbuf[n] = '\0';
+			return n;
+		}
+		close(*fd);
+		*fd = -1;
+		if (!reopen)
+			return -1;
+		reopen = false;
+		*reopened = true;
+	}
+}
+
+static void _handle_stats(List prec_list, pid_t pid, proc_fd_t *pfd,
 			  jag_callbacks_t *callbacks,
 			  int tres_count)
 {
 	static int no_share_data = -1;
 	static int use_pss = -1;
-	FILE *stat_fp = NULL;
-	FILE *io_fp = NULL;
-	int fd, fd2, i;
+	proc_fd_t local_fd;
+	char proc_stat_file[64];
+	char proc_smaps_file[64];
+	char sbuf[512];
+	int i;
+	bool reopened;
 	jag_prec_t *prec = NULL;
 
 	if (no_share_data == -1) {
@@ -513,33 +601,30 @@ static void _handle_stats(List prec_list, char *proc_stat_file,
 		xfree(acct_params);
 	}
 
-	if (!(stat_fp = fopen(proc_stat_file, "r")))
-		return;  /* Assume the process went away */
-	/*
-	 * Close the file on exec() of user tasks.
-	 *
-	 * NOTE: If we fork() slurmstepd after the
-	 * fopen() above and before the fcntl() below,
-	 * then the user task may have this extra file
-	 * open, which can cause problems for
-	 * checkpoint/restart, but this should be a very rare
-	 * problem in practice.
-	 */
-	fd = fileno(stat_fp);
-	if (fcntl(fd, F_SETFD, FD_CLOEXEC) == -1)
-		error("%s: fcntl(%s): %m", __func__, proc_stat_file);
-
-	prec = xmalloc(sizeof(jag_prec_t));
+	/* Processes beyond PROC_FD_MAX have their files opened every poll */
+	if (!pfd) {
+		local_fd.pid = pid;
+		local_fd.stat_fd = -1;
+		local_fd.io_fd = -1;
+		local_fd.lwp = -1;
+		pfd = &local_fd;
+	}
 
-	if (!tres_count) {
-		assoc_mgr_lock_t locks = {
-			NO_LOCK, NO_LOCK, NO_LOCK, NO_LOCK,
-			READ_LOCK, NO_LOCK, NO_LOCK };
-		assoc_mgr_lock(&locks);
-		tres_count = g_tres_count;
-		assoc_mgr_unlock(&locks);
+	if (_proc_read(pid, "stat", &pfd->stat_fd, sbuf, sizeof(sbuf),
+		       &reopened) < 0) {
+		pfd->lwp = -1;
+		goto end_it;
+	}
+	if (reopened) {
+		/* The pid may now be another process, drop what was kept */
+		pfd->lwp = -1;
+		if (pfd->io_fd >= 0) {
+			close(pfd->io_fd);
+			pfd->io_fd = -1;
+		}
 	}
 
+	prec = xmalloc(sizeof(jag_prec_t));
 	prec->tres_count = tres_count;
 	prec->tres_data = xmalloc(prec->tres_count *
 				  sizeof(acct_gather_data_t));
@@ -552,13 +637,19 @@ static void _handle_stats(List prec_list, char *proc_stat_file,
 		prec->tres_data[i].size_write = INFINITE64;
 	}
 
-	if (!_get_process_data_line(fd, prec)) {
-		xfree(prec->tres_data);
-		xfree(prec);
-		fclose(stat_fp);
-		return;
+	if (!_get_process_data_line(sbuf, prec)) {
+		destroy_jag_prec(prec);
+		goto end_it;
+	}
+
+	/* If current pid corresponds to a Light Weight Process (Thread POSIX) */
+	/* skip it, we will only account the original process (pid==tgid) */
+	if (pfd->lwp < 0)
+		pfd->lwp = _is_a_lwp(prec->pid);
+	if (pfd->lwp > 0) {
+		destroy_jag_prec(prec);
+		goto end_it;
 	}
-	fclose(stat_fp);
 
 	if (acct_gather_filesystem_g_get_data(prec->tres_data) < 0) {
 		debug2("problem retrieving filesystem data");
@@ -569,82 +660,106 @@ static void _handle_stats(List prec_list, char *proc_stat_file,
 	}
 
 	/* Remove shared data from rss */
-	if (no_share_data)
+	if (no_share_data) {
+		snprintf(proc_stat_file, sizeof(proc_stat_file),
+			 "/proc/%d/stat", (int) pid);
 		_remove_share_data(proc_stat_file, prec);
+	}
 
 	/* Use PSS instead if RSS */
 	if (use_pss) {
+		snprintf(proc_smaps_file, sizeof(proc_smaps_file),
+			 "/proc/%d/smaps", (int) pid);
 		if (_get_pss(proc_smaps_file, prec) == -1) {
-			xfree(prec->tres_data);
-			xfree(prec);
-			return;
+			destroy_jag_prec(prec);
+			goto end_it;
 		}
 	}
 
 	list_append(prec_list, prec);
 
-	if ((io_fp = fopen(proc_io_file, "r"))) {
-		fd2 = fileno(io_fp);
-		if (fcntl(fd2, F_SETFD, FD_CLOEXEC) == -1)
-			error("%s: fcntl: %m", __func__);
-		_get_process_io_data_line(fd2, prec);
-		fclose(io_fp);
+	/* A reopened io file is of a process started after the stat read */
+	if (_proc_read(pid, "io", &pfd->io_fd, sbuf, sizeof(sbuf),
+		       &reopened) > 0) {
+		if (reopened)
+			pfd->lwp = -1;
+		else
+			_get_process_io_data_line(sbuf, prec);
+	}
+
+end_it:
+	if (pfd == &local_fd)
+		_proc_fd_close(pfd);
+}
+
+static int _get_tres_count(struct jobacctinfo *jobacct)
+{
+	int tres_count = 0;
+
+	if (jobacct)
+		tres_count = jobacct->tres_count;
+	if (!tres_count) {
+		assoc_mgr_lock_t locks = {
+			NO_LOCK, NO_LOCK, NO_LOCK, NO_LOCK,
+			READ_LOCK, NO_LOCK, NO_LOCK };
+		assoc_mgr_lock(&locks);
+		tres_count = g_tres_count;
+		assoc_mgr_unlock(&locks);
 	}
+
+	return tres_count;
+}
+
+static void _get_energy_no_pids(struct jobacctinfo *jobacct)
+{
+	if (!jobacct)
+		return;
+
+	acct_gather_energy_g_get_data(energy_profile, &jobacct->energy);
+	jobacct->tres_usage_in_tot[TRES_ARRAY_ENERGY] =
+		jobacct->energy.consumed_energy;
+	jobacct->tres_usage_out_tot[TRES_ARRAY_ENERGY] =
+		jobacct->energy.current_watts;
+	debug2("%s: energy = %"PRIu64" watts = %"PRIu64, __func__,
+	       jobacct->tres_usage_in_tot[TRES_ARRAY_ENERGY],
+	       jobacct->tres_usage_out_tot[TRES_ARRAY_ENERGY]);
 }
 
 static List _get_precs(List task_list, bool pgid_plugin, uint64_t cont_id,
 		       jag_callbacks_t *callbacks)
 {
 	List prec_list = list_create(destroy_jag_prec);
-	char	proc_stat_file[256];	/* Allow ~20x extra length */
-	char	proc_io_file[256];	/* Allow ~20x extra length */
-	char	proc_smaps_file[256];	/* Allow ~20x extra length */
 	static	int	slash_proc_open = 0;
-	int i;
+	int i, tres_count = 0;
 	struct jobacctinfo *jobacct = NULL;
 
 	xassert(task_list);
 
 	jobacct = list_peek(task_list);
+	tres_count = _get_tres_count(jobacct);
 
 	if (!pgid_plugin) {
 		pid_t *pids = NULL;
 		int npids = 0;
 		/* get only the processes in the proctrack container */
 		proctrack_g_get_pids(cont_id, &pids, &npids);
+		_proc_fd_update(pids, npids);
 		if (!npids) {
 			/* update consumed energy even if pids do not exist */
-			if (jobacct) {
-				acct_gather_energy_g_get_data(
-					energy_profile,
-					&jobacct->energy);
-				jobacct->tres_usage_in_tot[TRES_ARRAY_ENERGY] =
-					jobacct->energy.consumed_energy;
-				jobacct->tres_usage_out_tot[TRES_ARRAY_ENERGY] =
-					jobacct->energy.current_watts;
-				debug2("%s: energy = %"PRIu64" watts = %"PRIu64,
-				       __func__,
-				       jobacct->tres_usage_in_tot[
-					       TRES_ARRAY_ENERGY],
-				       jobacct->tres_usage_out_tot[
-					       TRES_ARRAY_ENERGY]);
-			}
-
+			_get_energy_no_pids(jobacct);
 			debug4("no pids in this container %"PRIu64"", cont_id);
 			goto finished;
 		}
 		for (i = 0; i < npids; i++) {
-			snprintf(proc_stat_file, 256, "/proc/%d/stat", pids[i]);
-			snprintf(proc_io_file, 256, "/proc/%d/io", pids[i]);
-			snprintf(proc_smaps_file, 256, "/proc/%d/smaps", pids[i]);
-			_handle_stats(prec_list, proc_stat_file, proc_io_file,
-				      proc_smaps_file, callbacks,
-				      jobacct ? jobacct->tres_count : 0);
+			_handle_stats(prec_list, pids[i],
+				      _proc_fd_find(pids[i]), callbacks,
+				      tres_count);
 		}
 		xfree(pids);
 	} else {
 		struct dirent *slash_proc_entry;
-		char  *iptr = NULL, *optr = NULL, *optr2 = NULL;
+		char *iptr;
+		pid_t pid;
 
 		if (slash_proc_open) {
 			rewinddir(slash_proc);
@@ -656,84 +771,66 @@ static List _get_precs(List task_list, bool pgid_plugin, uint64_t cont_id,
 			}
 			slash_proc_open=1;
 		}
-		strcpy(proc_stat_file, "/proc/");
-		strcpy(proc_io_file, "/proc/");
-		strcpy(proc_smaps_file, "/proc/");
 
 		while ((slash_proc_entry = readdir(slash_proc))) {
-
-			/* Save a few cyles by simulating
-			 * strcat(statFileName, slash_proc_entry->d_name);
-			 * strcat(statFileName, "/stat");
-			 * while checking for a numeric filename (which really
-			 * should be a pid). Then do the same for the
-			 * /proc/<pid>/io file name.
-			 */
-			optr = proc_stat_file + sizeof("/proc");
+			/* Only numeric file names, which really are pids */
 			iptr = slash_proc_entry->d_name;
-			i = 0;
+			pid = 0;
 			do {
-				if ((*iptr < '0') ||
-				    ((*optr++ = *iptr++) > '9')) {
-					i = -1;
+				if ((*iptr < '0') || (*iptr > '9')) {
+					pid = -1;
 					break;
 				}
+				pid = (pid * 10) + (*iptr++ - '0');
 			} while (*iptr);
-
-			if (i == -1)
+			if (pid <= 0)
 				continue;
-			iptr = (char*)"/stat";
 
-			do {
-				*optr++ = *iptr++;
-			} while (*iptr);
-			*optr = 0;
+			_handle_stats(prec_list, pid, NULL, callbacks,
+				      tres_count);
+		}
+	}
 
-			optr2 = proc_io_file + sizeof("/proc");
-			iptr = slash_proc_entry->d_name;
-			i = 0;
-			do {
-				if ((*iptr < '0') ||
-				    ((*optr2++ = *iptr++) > '9')) {
-					i = -1;
-					break;
-				}
-			} while (*iptr);
-			if (i == -1)
-				continue;
-			iptr = (char*)"/io";
+finished:
 
-			do {
-				*optr2++ = *iptr++;
-			} while (*iptr);
-			*optr2 = 0;
+	return prec_list;
+}
 
-			optr2 = proc_smaps_file + sizeof("/proc");
-			iptr = slash_proc_entry->d_name;
-			i = 0;
-			do {
-				if ((*iptr < '0') ||
-				    ((*optr2++ = *iptr++) > '9')) {
-					i = -1;
-					break;
-				}
-			} while (*iptr);
-			if (i == -1)
-				continue;
-			iptr = (char*)"/smaps";
+/*
+ * Like _get_precs(), but only read /proc for the tasks themselves and not
+ * for any other process in the container. For plugins whose prec_extra
+ * callback reads each task's totals from elsewhere.
+ */
+extern List jag_common_get_task_precs(List task_list, bool pgid_plugin,
+				      uint64_t cont_id,
+				      jag_callbacks_t *callbacks)
+{
+	List prec_list = list_create(destroy_jag_prec);
+	struct jobacctinfo *jobacct;
+	ListIterator itr;
+	pid_t *pids;
+	int i, npids = 0, tres_count;
 
-			do {
-				*optr2++ = *iptr++;
-			} while (*iptr);
-			*optr2 = 0;
+	xassert(task_list);
 
-			_handle_stats(prec_list, proc_stat_file, proc_io_file,
-				      proc_smaps_file,callbacks,
-				      jobacct ? jobacct->tres_count : 0);
-		}
+	pids = xmalloc(sizeof(pid_t) * (list_count(task_list) + 1));
+	itr = list_iterator_create(task_list);
+	while ((jobacct = list_next(itr)))
+		pids[npids++] = jobacct->pid;
+	list_iterator_destroy(itr);
+
+	jobacct = list_peek(task_list);
+	tres_count = _get_tres_count(jobacct);
+
+	_proc_fd_update(pids, npids);
+	for (i = 0; i < npids; i++) {
+		_handle_stats(prec_list, pids[i], _proc_fd_find(pids[i]),
+			      callbacks, tres_count);
 	}
+	xfree(pids);
 
-finished:
+	if (!list_count(prec_list))
+		_get_energy_no_pids(jobacct);
 
 	return prec_list;
 }
@@ -887,6 +984,8 @@ extern void jag_common_fini(void)
 {
 	if (slash_proc)
 		(void) closedir(slash_proc);
+	_proc_fd_update(NULL, 0);
+	xfree(proc_fd);
 }
 
 extern void destroy_jag_prec(void *object)
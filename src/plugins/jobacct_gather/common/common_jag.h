@@ -69,6 +69,11 @@ extern void jag_common_fini(void);
 extern void destroy_jag_prec(void *object);
 extern void print_jag_prec(jag_prec_t *prec);
 
+/* get_precs callback reading /proc only for the tasks in task_list */
+extern List jag_common_get_task_precs(List task_list, bool pgid_plugin,
+				      uint64_t cont_id,
+				      jag_callbacks_t *callbacks);
+
 extern void jag_common_poll_data(
 	List task_list, bool pgid_plugin, uint64_t cont_id,
 	jag_callbacks_t *callbacks, bool profile);
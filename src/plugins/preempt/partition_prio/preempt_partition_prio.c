@@ -49,6 +49,7 @@
 #include "src/common/xstring.h"
 #include "src/slurmctld/slurmctld.h"
 #include "src/slurmctld/job_scheduler.h"
+#include "src/slurmctld/preempt.h"
 
 const char	plugin_name[]	= "Preempt by partition priority plugin";
 const char	plugin_type[]	= "preempt/partition_prio";
@@ -80,7 +81,7 @@ extern List find_preemptable_jobs(struct job_record *job_ptr)
 {
 	ListIterator job_iterator;
 	struct job_record *job_p;
-	List preemptee_job_list = NULL;
+	List active_job_list, preemptee_job_list = NULL;
 
 	/* Validate the preemptor job */
 	if (job_ptr == NULL) {
@@ -101,11 +102,13 @@ extern List find_preemptable_jobs(struct job_record *job_ptr)
 		return preemptee_job_list;
 	}
 
-	/* Build an array of pointers to preemption candidates */
-	job_iterator = list_iterator_create(job_list);
+	/*
+	 * Build an array of pointers to preemption candidates, only running
+	 * and suspended jobs need be considered
+	 */
+	active_job_list = slurm_preempt_active_jobs();
+	job_iterator = list_iterator_create(active_job_list);
 	while ((job_p = (struct job_record *) list_next(job_iterator))) {
-		if (!IS_JOB_RUNNING(job_p) && !IS_JOB_SUSPENDED(job_p))
-			continue;
 		if ((job_p->part_ptr == NULL) ||
 		    (job_p->part_ptr->priority_tier >=
 		     job_ptr->part_ptr->priority_tier) ||
@@ -126,6 +129,7 @@ extern List find_preemptable_jobs(struct job_record *job_ptr)
 		list_append(preemptee_job_list, job_p);
 	}
 	list_iterator_destroy(job_iterator);
+	FREE_NULL_LIST(active_job_list);
 
 	if (preemptee_job_list && youngest_order)
 		list_sort(preemptee_job_list, _sort_by_youngest);
@@ -1707,30 +1707,18 @@ static int _attempt_backfill(void)
 		}
 
 		if (job_ptr->qos_id) {
-			assoc_mgr_lock_t locks = {
-				READ_LOCK, NO_LOCK, READ_LOCK, NO_LOCK,
-				NO_LOCK, NO_LOCK, NO_LOCK };
-
-			assoc_mgr_lock(&locks);
-			if (job_ptr->assoc_ptr
-			    && (accounting_enforce & ACCOUNTING_ENFORCE_QOS)
-			    && ((job_ptr->qos_id >= g_qos_count) ||
-				!bit_test(job_ptr->assoc_ptr->usage->valid_qos,
-					  job_ptr->qos_id))
-			    && !job_ptr->limit_set.qos) {
+			if (acct_policy_job_qos_invalid(job_ptr)) {
 				debug("backfill: %pJ has invalid QOS",
 				      job_ptr);
 				xfree(job_ptr->state_desc);
 				job_ptr->state_reason = FAIL_QOS;
 				last_job_update = now;
-				assoc_mgr_unlock(&locks);
 				continue;
 			} else if (job_ptr->state_reason == FAIL_QOS) {
 				xfree(job_ptr->state_desc);
 				job_ptr->state_reason = WAIT_NO_REASON;
 				last_job_update = now;
 			}
-			assoc_mgr_unlock(&locks);
 		}
 
 		assoc_mgr_lock(&qos_read_lock);
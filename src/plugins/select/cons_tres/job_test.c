@@ -41,6 +41,9 @@
 
 #define _DEBUG 0	/* Enables module specific debugging */
 
+/* Minimum candidate node count per _get_res_avail() worker thread */
+#define RES_AVAIL_THREAD_MIN_NODES 256
+
 /*
  * These symbols are defined here so when we link with something other
  * than the slurmctld we will have these symbols defined. They will get
@@ -65,13 +68,60 @@ typedef struct avail_res {	/* Per-node resource availability */
 	List sock_gres_list;	/* Per-socket GRES availability, sock_gres_t */
 	uint16_t spec_threads;	/* Specialized threads to be reserved */
 	uint16_t vpus;		/* Virtual processors (CPUs) per core */
+	uint16_t sock_alloc;	/* Size of avail_cores_per_sock array */
+	struct avail_res *next;	/* Next record in avail_res_pool */
 } avail_res_t;
 
+/*
+ * Released avail_res_t records, reused by _allocate_sc() rather than
+ * allocating a new record for every node of every job test
+ */
+static pthread_mutex_t avail_res_pool_mutex = PTHREAD_MUTEX_INITIALIZER;
+static avail_res_t *avail_res_pool = NULL;
+static int avail_res_pool_cnt = 0;
+
+/* Arguments for evaluating a range of nodes in _get_res_avail() */
+typedef struct res_avail_args {
+	struct job_record *job_ptr;
+	bitstr_t *node_map;
+	bitstr_t **core_map;
+	struct node_use_record *node_usage;
+	uint16_t cr_type;
+	bool test_only;
+	bitstr_t **part_core_map;
+	uint32_t s_p_n;
+	avail_res_t **avail_res_array;	/* Shared, indexed by node */
+	int i_first;			/* First node index to evaluate */
+	int i_last;			/* Last node index to evaluate */
+} res_avail_args_t;
+
+/*
+ * Worker threads for _get_res_avail(), started by start_avail_res_workers()
+ * so that a job test does not pay for creating and joining threads. The
+ * ranges of one job test are published in avail_res_work and claimed one at
+ * a time by the workers and the calling thread.
+ */
+static pthread_mutex_t avail_res_work_mutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t avail_res_work_cond = PTHREAD_COND_INITIALIZER;
+static pthread_cond_t avail_res_done_cond = PTHREAD_COND_INITIALIZER;
+static pthread_t *avail_res_worker_ids = NULL;
+static int avail_res_worker_cnt = 0;
+static bool avail_res_worker_shutdown = false;
+static res_avail_args_t *avail_res_work = NULL;
+static int avail_res_work_cnt = 0;	/* Ranges in avail_res_work */
+static int avail_res_work_next = 0;	/* Next range to be claimed */
+static int avail_res_work_pending = 0;	/* Ranges not yet completed */
+
 struct sort_support {
 	int jstart;
 	struct job_resources *tmpjobs;
 };
 
+typedef struct switch_sort {
+	int switch_inx;		/* index into switch_record_table */
+	int node_cnt;		/* available nodes on switch */
+} switch_sort_t;
+
 typedef struct node_weight_struct {
 	bitstr_t *node_bitmap;	/* bitmap of nodes with this weight */
 	uint32_t weight;	/* priority of node for scheduling work on */
@@ -90,6 +140,7 @@ static void _block_whole_nodes(bitstr_t *node_bitmap,
 static gres_mc_data_t *_build_gres_mc_data(struct job_record *job_ptr);
 static List _build_node_weight_list(bitstr_t *node_bitmap);
 static int  _compare_support(const void *v, const void *v1);
+static int  _compare_switch_sort(const void *v1, const void *v2);
 static void _cpus_to_use(uint16_t *avail_cpus, int64_t rem_cpus, int rem_nodes,
 			 struct job_details *details_ptr,
 			 avail_res_t *avail_res, int node_inx,
@@ -144,6 +195,7 @@ static int _eval_nodes_topo(struct job_record *job_ptr,
 			    uint32_t max_nodes, uint32_t req_nodes,
 			    avail_res_t **avail_res_array, uint16_t cr_type,
 			    bool prefer_alloc_nodes, bool first_pass);
+static avail_res_t *_alloc_avail_res(uint16_t sockets);
 static void _free_avail_res(avail_res_t *avail_res);
 static void _free_avail_res_array(avail_res_t **avail_res);
 static avail_res_t **_get_res_avail(struct job_record *job_ptr,
@@ -253,11 +305,63 @@ static List _build_node_weight_list(bitstr_t *node_bitmap)
 	return node_list;
 }
 
+/*
+ * Get a cleared avail_res_t record with room for "sockets" per-socket core
+ * counts, call _free_avail_res() to release
+ */
+static avail_res_t *_alloc_avail_res(uint16_t sockets)
+{
+	avail_res_t *avail_res;
+	uint16_t *avail_cores_per_sock = NULL;
+	uint16_t sock_alloc = 0;
+
+	slurm_mutex_lock(&avail_res_pool_mutex);
+	if ((avail_res = avail_res_pool)) {
+		avail_res_pool = avail_res->next;
+		avail_res_pool_cnt--;
+	}
+	slurm_mutex_unlock(&avail_res_pool_mutex);
+
+	if (!avail_res) {
+		avail_res = xmalloc(sizeof(avail_res_t));
+		avail_res->avail_cores_per_sock =
+			xmalloc(sizeof(uint16_t) * sockets);
+		avail_res->sock_alloc = sockets;
+		return avail_res;
+	}
+
+	avail_cores_per_sock = avail_res->avail_cores_per_sock;
+	sock_alloc = avail_res->sock_alloc;
+	if (sock_alloc < sockets) {
+		xrealloc(avail_cores_per_sock, sizeof(uint16_t) * sockets);
+		sock_alloc = sockets;
+	}
+	memset(avail_res, 0, sizeof(avail_res_t));
+	memset(avail_cores_per_sock, 0, sizeof(uint16_t) * sock_alloc);
+	avail_res->avail_cores_per_sock = avail_cores_per_sock;
+	avail_res->sock_alloc = sock_alloc;
+
+	return avail_res;
+}
+
+/* Release an avail_res_t record, keeping up to one per node for reuse */
 static void _free_avail_res(avail_res_t *avail_res)
 {
+	if (!avail_res)
+		return;
+
+	FREE_NULL_LIST(avail_res->sock_gres_list);
+	slurm_mutex_lock(&avail_res_pool_mutex);
+	if (avail_res_pool_cnt < select_node_cnt) {
+		avail_res->next = avail_res_pool;
+		avail_res_pool = avail_res;
+		avail_res_pool_cnt++;
+		avail_res = NULL;
+	}
+	slurm_mutex_unlock(&avail_res_pool_mutex);
+
 	if (avail_res) {
 		xfree(avail_res->avail_cores_per_sock);
-		FREE_NULL_LIST(avail_res->sock_gres_list);
 		xfree(avail_res);
 	}
 }
@@ -585,6 +689,13 @@ extern int rm_job_res(struct part_res_record *part_record_ptr,
 
 		node_ptr = node_record_table_ptr + i;
 		if (action != 2) {
+			if (!node_usage[i].gres_list &&
+			    (node_usage != select_node_usage)) {
+				/* Copy-on-write, see _dup_node_usage() */
+				node_usage[i].gres_list =
+					gres_plugin_node_state_dup(
+						node_ptr->gres_list);
+			}
 			if (node_usage[i].gres_list)
 				gres_list = node_usage[i].gres_list;
 			else
@@ -643,6 +754,11 @@ extern int rm_job_res(struct part_res_record *part_record_ptr,
 
 		if (!p_ptr->row)
 			return SLURM_SUCCESS;
+		if (p_ptr->rows_shared) {
+			/* Copy-on-write, see _dup_part_data() */
+			p_ptr->row = _dup_row_data(p_ptr->row, p_ptr->num_rows);
+			p_ptr->rows_shared = false;
+		}
 
 		/* remove the job from the job_list */
 		n = 0;
@@ -928,6 +1044,17 @@ static int _compare_support(const void *v1, const void *v2)
 	return 0;
 }
 
+/* Sort switches by decreasing node count, then increasing switch index */
+static int _compare_switch_sort(const void *v1, const void *v2)
+{
+	switch_sort_t *s1 = (switch_sort_t *) v1;
+	switch_sort_t *s2 = (switch_sort_t *) v2;
+
+	if (s1->node_cnt != s2->node_cnt)
+		return (s2->node_cnt - s1->node_cnt);
+	return (s1->switch_inx - s2->switch_inx);
+}
+
 /*
  * Return the number of usable logical processors by a given job on
  * some specified node. Returns 0xffff if no limit.
@@ -958,11 +1085,14 @@ extern int vpus_per_core(struct job_details *details, int node_inx)
 	return vpus_per_core;
 }
 
-/* Create a duplicate part_res_record list */
+/*
+ * Create a duplicate node_use_record array
+ * Nodes without a gres_list of their own leave gres_list NULL in the copy,
+ * rm_job_res() copies the node's gres state when it first changes.
+ */
 static struct node_use_record *_dup_node_usage(struct node_use_record *orig_ptr)
 {
 	struct node_use_record *new_use_ptr, *new_ptr;
-	List gres_list;
 	uint32_t i;
 
 	if (orig_ptr == NULL)
@@ -974,16 +1104,20 @@ static struct node_use_record *_dup_node_usage(struct node_use_record *orig_ptr)
 	for (i = 0; i < select_node_cnt; i++) {
 		new_ptr[i].node_state   = orig_ptr[i].node_state;
 		new_ptr[i].alloc_memory = orig_ptr[i].alloc_memory;
-		if (orig_ptr[i].gres_list)
-			gres_list = orig_ptr[i].gres_list;
-		else
-			gres_list = node_record_table_ptr[i].gres_list;
-		new_ptr[i].gres_list = gres_plugin_node_state_dup(gres_list);
+		if (orig_ptr[i].gres_list) {
+			new_ptr[i].gres_list =
+				gres_plugin_node_state_dup(orig_ptr[i].gres_list);
+		}
 	}
 	return new_use_ptr;
 }
 
-/* Create a duplicate part_res_record list */
+/*
+ * Create a duplicate part_res_record list
+ * The copy shares the original's row arrays, rm_job_res() and _job_test()
+ * copy a partition's rows before they change or reorder them. The original
+ * must not be modified or freed while the copy is in use.
+ */
 static struct part_res_record *_dup_part_data(struct part_res_record *orig_ptr)
 {
 	struct part_res_record *new_part_ptr, *new_ptr;
@@ -997,8 +1131,8 @@ static struct part_res_record *_dup_part_data(struct part_res_record *orig_ptr)
 	while (orig_ptr) {
 		new_ptr->part_ptr = orig_ptr->part_ptr;
 		new_ptr->num_rows = orig_ptr->num_rows;
-		new_ptr->row = _dup_row_data(orig_ptr->row,
-					     orig_ptr->num_rows);
+		new_ptr->row = orig_ptr->row;
+		new_ptr->rows_shared = true;
 		if (orig_ptr->next) {
 			new_ptr->next = xmalloc(sizeof(struct part_res_record));
 			new_ptr = new_ptr->next;
@@ -1744,8 +1878,15 @@ static int _job_test(struct job_record *job_ptr, bitstr_t *node_bitmap,
 	}
 
 
-	if ((jp_ptr->num_rows > 1) && !preempt_by_qos)
+	if ((jp_ptr->num_rows > 1) && !preempt_by_qos) {
+		if (jp_ptr->rows_shared) {
+			/* Copy-on-write, see _dup_part_data() */
+			jp_ptr->row = _dup_row_data(jp_ptr->row,
+						    jp_ptr->num_rows);
+			jp_ptr->rows_shared = false;
+		}
 		cr_sort_part_rows(jp_ptr);	/* Preserve row order for QOS */
+	}
 	c = jp_ptr->num_rows;
 	if (preempt_by_qos && !qos_preemptor)
 		c--;				/* Do not use extra row */
@@ -3469,6 +3610,7 @@ static int _eval_nodes_dfly(struct job_record *job_ptr,
 	int leaf_switch_count = 0, req_leaf_switch_count = 0;
 	int top_switch_inx = -1;
 	int prev_rem_nodes;
+	int *switch_next_node = NULL;		/* next node to test on switch */
 
 	if (job_ptr->req_switch > 1) {
 		/* Maximum leaf switch count >1 probably makes no sense */
@@ -3979,8 +4121,14 @@ static int _eval_nodes_dfly(struct job_record *job_ptr,
 
 	/*
 	 * Add additional resources as required from additional leaf switches
-	 * on a round-robin basis
+	 * on a round-robin basis. Nodes are only ever added to node_map here,
+	 * so each pass resumes a switch's scan after the last node it took.
 	 */
+	switch_next_node = xmalloc(sizeof(int) * switch_record_cnt);
+	for (i = 0; i < switch_record_cnt; i++) {
+		if (switch_node_bitmap[i])
+			switch_next_node[i] = bit_ffs(switch_node_bitmap[i]);
+	}
 	prev_rem_nodes = rem_nodes + 1;
 	while (1) {
 		if (prev_rem_nodes == rem_nodes)
@@ -3997,18 +4145,19 @@ static int _eval_nodes_dfly(struct job_record *job_ptr,
 		}
 		for (i = 0; i < switch_record_cnt; i++) {
 			if (!switch_node_bitmap[i] ||
-			    (switch_record_table[i].level != 0))
+			    (switch_record_table[i].level != 0) ||
+			    (switch_next_node[i] < 0))
 				continue;
-			i_first = bit_ffs(switch_node_bitmap[i]);
-			if (i_first >= 0)
-				i_last = bit_fls(switch_node_bitmap[i]);
-			else
-				i_last = -2;
+			i_first = switch_next_node[i];
+			i_last = bit_fls(switch_node_bitmap[i]);
+			switch_next_node[i] = -1;
 			for (j = i_first; j <= i_last; j++) {
 				if (!bit_test(switch_node_bitmap[i], j) ||
 				    bit_test(node_map, j) ||
 				    !avail_cpu_per_node[j])
 					continue;
+				if (j < i_last)
+					switch_next_node[i] = j + 1;
 				avail_cpus = avail_cpu_per_node[j];
 				rem_nodes--;
 				min_rem_nodes--;
@@ -4064,6 +4213,7 @@ fini:	FREE_NULL_LIST(best_gres);
 			FREE_NULL_BITMAP(switch_node_bitmap[i]);
 		xfree(switch_node_bitmap);
 	}
+	xfree(switch_next_node);
 	xfree(switch_node_cnt);
 	xfree(switch_required);
 	return rc;
@@ -4107,6 +4257,8 @@ static int _eval_nodes_topo(struct job_record *job_ptr,
 	int leaf_switch_count = 0, req_leaf_switch_count = 0;
 	int top_switch_inx = -1;
 	int prev_rem_nodes;
+	switch_sort_t *leaf_switch_sort = NULL;	/* candidate leaf switches */
+	int k, leaf_sort_cnt = 0;
 
 	if (job_ptr->req_switch) {
 		time_t     time_now;
@@ -4553,9 +4705,24 @@ static int _eval_nodes_topo(struct job_record *job_ptr,
 		}
 	}
 
-	/* Add additional resources as required from additional leaf switches */
+	/*
+	 * Add additional resources as required from additional leaf switches,
+	 * those with the most available nodes first. Switch node counts do
+	 * not change below, so order the candidate switches just once.
+	 */
+	leaf_switch_sort = xmalloc(sizeof(switch_sort_t) * switch_record_cnt);
+	for (i = 0; i < switch_record_cnt; i++) {
+		if (switch_required[i] || !switch_node_bitmap[i] ||
+		    (switch_record_table[i].level != 0) || !switch_node_cnt[i])
+			continue;
+		leaf_switch_sort[leaf_sort_cnt].switch_inx = i;
+		leaf_switch_sort[leaf_sort_cnt].node_cnt = switch_node_cnt[i];
+		leaf_sort_cnt++;
+	}
+	qsort(leaf_switch_sort, leaf_sort_cnt, sizeof(switch_sort_t),
+	      _compare_switch_sort);
 	prev_rem_nodes = rem_nodes + 1;
-	while (1) {
+	for (k = 0; ; k++) {
 		if (prev_rem_nodes == rem_nodes)
 			break; 	/* Stalled */
 		prev_rem_nodes = rem_nodes;
@@ -4569,19 +4736,9 @@ static int _eval_nodes_topo(struct job_record *job_ptr,
 			rc = SLURM_ERROR;
 			goto fini;
 		}
-		top_switch_inx = -1;
-		for (i = 0; i < switch_record_cnt; i++) {
-			if (switch_required[i] || !switch_node_bitmap[i] ||
-			    (switch_record_table[i].level != 0))
-				continue;
-			if (switch_node_cnt[i] &&
-			    ((top_switch_inx == -1) ||
-			     (switch_node_cnt[i] >
-			      switch_node_cnt[top_switch_inx])))
-				top_switch_inx = i;
-		}
-		if (top_switch_inx == -1)
+		if (k >= leaf_sort_cnt)
 			break;
+		top_switch_inx = leaf_switch_sort[k].switch_inx;
 
 		/*
 		 * NOTE: Ideally we would add nodes in order of resource
@@ -4619,7 +4776,6 @@ static int _eval_nodes_topo(struct job_record *job_ptr,
 				goto fini;
 			}
 		}
-		switch_node_cnt[top_switch_inx] = 0;	/* Used all */
 	}
 	if ((min_rem_nodes <= 0) && (rem_cpus <= 0) &&
 	    (!gres_per_job ||
@@ -4643,6 +4799,7 @@ fini:	FREE_NULL_LIST(best_gres);
 			FREE_NULL_BITMAP(switch_node_bitmap[i]);
 		xfree(switch_node_bitmap);
 	}
+	xfree(leaf_switch_sort);
 	xfree(switch_node_cnt);
 	xfree(switch_required);
 	return rc;
@@ -5647,10 +5804,9 @@ fini:
 	}
 	cpu_count -= spec_threads;
 
-	avail_res = xmalloc(sizeof(avail_res_t));
+	avail_res = _alloc_avail_res(sockets);
 	avail_res->max_cpus = MIN(cpu_count, part_cpu_limit);
 	avail_res->min_cpus = *cpu_alloc_size;
-	avail_res->avail_cores_per_sock = xmalloc(sizeof(uint16_t) * sockets);
 	for (c = 0; c < select_node_record[node_i].tot_cores; c++) {
 		i = (uint16_t) (c / cores_per_socket);
 		if (bit_test(core_map, c))
@@ -6054,6 +6210,55 @@ static void _set_gpu_defaults(struct job_record *job_ptr)
 				 mem_per_gpu);
 }
 
+/* Determine resource availability for the nodes in one range of node_map */
+static void _get_res_avail_range(res_avail_args_t *args)
+{
+	int i;
+
+	for (i = args->i_first; i <= args->i_last; i++) {
+		if (!bit_test(args->node_map, i))
+			continue;
+		args->avail_res_array[i] = _can_job_run_on_node(
+					args->job_ptr, args->core_map, i,
+					args->s_p_n, args->node_usage,
+					args->cr_type, args->test_only,
+					args->part_core_map);
+	}
+}
+
+/*
+ * Evaluate unclaimed ranges of avail_res_work until none are left.
+ * avail_res_work_mutex must be locked when called and is locked on return.
+ */
+static void _run_avail_res_work(void)
+{
+	int t;
+
+	while (avail_res_work_next < avail_res_work_cnt) {
+		t = avail_res_work_next++;
+		slurm_mutex_unlock(&avail_res_work_mutex);
+		_get_res_avail_range(&avail_res_work[t]);
+		slurm_mutex_lock(&avail_res_work_mutex);
+		if (--avail_res_work_pending == 0)
+			slurm_cond_broadcast(&avail_res_done_cond);
+	}
+}
+
+static void *_avail_res_worker(void *arg)
+{
+	slurm_mutex_lock(&avail_res_work_mutex);
+	while (!avail_res_worker_shutdown) {
+		if (avail_res_work_next < avail_res_work_cnt)
+			_run_avail_res_work();
+		else
+			slurm_cond_wait(&avail_res_work_cond,
+					&avail_res_work_mutex);
+	}
+	slurm_mutex_unlock(&avail_res_work_mutex);
+
+	return NULL;
+}
+
 /*
  * Determine resource availability for pending job
  *
@@ -6077,21 +6282,86 @@ static avail_res_t **_get_res_avail(struct job_record *job_ptr,
 	avail_res_t **avail_res_array = NULL;
 	uint32_t s_p_n = _socks_per_node(job_ptr);
 
+	res_avail_args_t *args;
+	int node_cnt, thread_cnt, node_inx, per_thread, t;
+	bool shared = false;
+
 	_set_gpu_defaults(job_ptr);
 	avail_res_array = xmalloc(sizeof(avail_res_t *) * select_node_cnt);
 	i_first = bit_ffs(node_map);
-	if (i_first >= 0)
-		i_last = bit_fls(node_map);
-	else
-		i_last = i_first - 1;
+	if (i_first < 0)
+		return avail_res_array;
+	i_last = bit_fls(node_map);
+
+	node_cnt = bit_set_count(node_map);
+	slurm_mutex_lock(&avail_res_work_mutex);
+	thread_cnt = MIN(avail_res_worker_cnt + 1,
+			 node_cnt / RES_AVAIL_THREAD_MIN_NODES);
+	slurm_mutex_unlock(&avail_res_work_mutex);
+	if (thread_cnt < 1)
+		thread_cnt = 1;
+
+	/*
+	 * Split the candidate nodes into ranges of about equal node count.
+	 * Each node is evaluated independently and its result stored at its
+	 * own index, so the result matches that of a serial evaluation.
+	 */
+	args = xmalloc(sizeof(res_avail_args_t) * thread_cnt);
+	per_thread = (node_cnt + thread_cnt - 1) / thread_cnt;
+	node_inx = 0;
+	t = 0;
+	args[0].i_first = i_first;
 	for (i = i_first; i <= i_last; i++) {
 		if (!bit_test(node_map, i))
 			continue;
-		avail_res_array[i] = _can_job_run_on_node(job_ptr, core_map, i,
-							  s_p_n, node_usage,
-							  cr_type, test_only,
-							  part_core_map);
+		if ((node_inx++ == per_thread) && (t < (thread_cnt - 1))) {
+			args[t++].i_last = i - 1;
+			args[t].i_first = i;
+			node_inx = 1;
+		}
 	}
+	args[t].i_last = i_last;
+	thread_cnt = t + 1;
+
+	for (t = 0; t < thread_cnt; t++) {
+		args[t].job_ptr = job_ptr;
+		args[t].node_map = node_map;
+		args[t].core_map = core_map;
+		args[t].node_usage = node_usage;
+		args[t].cr_type = cr_type;
+		args[t].test_only = test_only;
+		args[t].part_core_map = part_core_map;
+		args[t].s_p_n = s_p_n;
+		args[t].avail_res_array = avail_res_array;
+	}
+
+	/*
+	 * Hand the ranges to the workers and help evaluate them. If another
+	 * job test is already using the workers, evaluate them all here.
+	 */
+	if (thread_cnt > 1) {
+		slurm_mutex_lock(&avail_res_work_mutex);
+		if (!avail_res_work_cnt) {
+			shared = true;
+			avail_res_work = args;
+			avail_res_work_cnt = thread_cnt;
+			avail_res_work_next = 0;
+			avail_res_work_pending = thread_cnt;
+			slurm_cond_broadcast(&avail_res_work_cond);
+			_run_avail_res_work();
+			while (avail_res_work_pending)
+				slurm_cond_wait(&avail_res_done_cond,
+						&avail_res_work_mutex);
+			avail_res_work = NULL;
+			avail_res_work_cnt = 0;
+		}
+		slurm_mutex_unlock(&avail_res_work_mutex);
+	}
+	if (!shared) {
+		for (t = 0; t < thread_cnt; t++)
+			_get_res_avail_range(&args[t]);
+	}
+	xfree(args);
 
 	return avail_res_array;
 }
@@ -6915,6 +7185,68 @@ extern bitstr_t **build_core_array(void)
 	return row_bitmap;
 }
 
+/* Free the avail_res_t records kept for reuse */
+/*
+ * Start the worker threads used by _get_res_avail(), replacing any already
+ * running. Workers are only started if node_cnt is large enough for a job
+ * test to be split between threads.
+ */
+extern void start_avail_res_workers(int node_cnt)
+{
+	int i, worker_cnt;
+
+	stop_avail_res_workers();
+
+	worker_cnt = MIN(select_thread_cnt,
+			 node_cnt / RES_AVAIL_THREAD_MIN_NODES) - 1;
+	if (worker_cnt < 1)
+		return;
+
+	avail_res_worker_ids = xmalloc(sizeof(pthread_t) * worker_cnt);
+	for (i = 0; i < worker_cnt; i++) {
+		slurm_thread_create(&avail_res_worker_ids[i],
+				    _avail_res_worker, NULL);
+	}
+	slurm_mutex_lock(&avail_res_work_mutex);
+	avail_res_worker_cnt = worker_cnt;
+	slurm_mutex_unlock(&avail_res_work_mutex);
+}
+
+/* Stop the worker threads started by start_avail_res_workers() */
+extern void stop_avail_res_workers(void)
+{
+	int i, worker_cnt;
+
+	slurm_mutex_lock(&avail_res_work_mutex);
+	worker_cnt = avail_res_worker_cnt;
+	avail_res_worker_cnt = 0;
+	avail_res_worker_shutdown = true;
+	slurm_cond_broadcast(&avail_res_work_cond);
+	slurm_mutex_unlock(&avail_res_work_mutex);
+
+	for (i = 0; i < worker_cnt; i++)
+		pthread_join(avail_res_worker_ids[i], NULL);
+	xfree(avail_res_worker_ids);
+
+	slurm_mutex_lock(&avail_res_work_mutex);
+	avail_res_worker_shutdown = false;
+	slurm_mutex_unlock(&avail_res_work_mutex);
+}
+
+extern void free_avail_res_pool(void)
+{
+	avail_res_t *avail_res;
+
+	slurm_mutex_lock(&avail_res_pool_mutex);
+	while ((avail_res = avail_res_pool)) {
+		avail_res_pool = avail_res->next;
+		xfree(avail_res->avail_cores_per_sock);
+		xfree(avail_res);
+	}
+	avail_res_pool_cnt = 0;
+	slurm_mutex_unlock(&avail_res_pool_mutex);
+}
+
 /* Clear all elements of an array of bitmaps, one per node */
 extern void clear_core_array(bitstr_t **core_array)
 {
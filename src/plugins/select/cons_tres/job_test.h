@@ -116,6 +116,9 @@ extern void core_array_or(bitstr_t **core_array1, bitstr_t **core_array2);
 /* Free an array of bitmaps, one per node */
 extern void free_core_array(bitstr_t ***core_array);
 
+/* Free the per-node resource availability records kept for reuse */
+extern void free_avail_res_pool(void);
+
 /*
  * Get configured DefCpuPerGPU information from a list
  * (either global or per partition list)
@@ -188,6 +191,15 @@ extern int run_now(struct job_record *job_ptr, bitstr_t *node_bitmap,
 		   List preemptee_candidates, List *preemptee_job_list,
 		   bitstr_t **exc_cores);
 
+/*
+ * Start the worker threads used to evaluate a job's candidate nodes in
+ * parallel, sized for a cluster of node_cnt nodes
+ */
+extern void start_avail_res_workers(int node_cnt);
+
+/* Stop the worker threads started by start_avail_res_workers() */
+extern void stop_avail_res_workers(void);
+
 /* Determine if a job can ever run */
 extern int test_only(struct job_record *job_ptr, bitstr_t *node_bitmap,
 		     uint32_t min_nodes, uint32_t max_nodes,
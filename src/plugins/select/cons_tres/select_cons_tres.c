@@ -149,6 +149,7 @@ struct node_res_record *select_node_record	= NULL;
 struct node_use_record *select_node_usage	= NULL;
 struct part_res_record *select_part_record	= NULL;
 bool       select_state_initializing = true;
+int        select_thread_cnt	= 4;
 bool       spec_cores_first	= false;
 bitstr_t **spec_core_res	= NULL;
 bool       topo_optional	= false;
@@ -369,6 +370,9 @@ static bitstr_t **_core_bitmap_to_array(bitstr_t *core_bitmap)
 			if (bit_test(core_bitmap, core_offset + c))
 				bit_set(core_array[node_inx], c);
 		}
+		/* Resume with the first core of the next node */
+		last_node_inx = node_inx + 1;
+		i = select_node_record[node_inx].cume_cores - 1;
 	}
 
 #if _DEBUG
@@ -949,6 +953,8 @@ extern int fini(void)
 	cr_destroy_part_data(select_part_record);
 	select_part_record = NULL;
 	free_core_array(&spec_core_res);
+	stop_avail_res_workers();
+	free_avail_res_pool();
 	cr_fini_global_core_data();
 
 	return SLURM_SUCCESS;
@@ -1038,6 +1044,15 @@ extern int select_p_node_init(struct node_record *node_ptr, int node_cnt)
 		pack_serial_at_end = true;
 	else
 		pack_serial_at_end = false;
+	if ((tmp_ptr = xstrcasestr(sched_params, "select_thread_count="))) {
+		select_thread_cnt = atoi(tmp_ptr + 20);
+		if (select_thread_cnt < 1) {
+			error("Invalid SchedulerParameters select_thread_count: %d",
+			      select_thread_cnt);
+			select_thread_cnt = 4;		/* Use default value */
+		}
+	} else
+		select_thread_cnt = 4;
 	if (xstrcasestr(sched_params, "spec_cores_first"))
 		spec_cores_first = true;
 	else
@@ -1113,6 +1128,7 @@ extern int select_p_node_init(struct node_record *node_ptr, int node_cnt)
 	}
 	_create_part_data();
 	_dump_nodes();
+	start_avail_res_workers(select_node_cnt);
 
 	return SLURM_SUCCESS;
 }
@@ -2689,10 +2705,10 @@ extern void cr_destroy_part_data(struct part_res_record *this_ptr)
 		this_ptr = this_ptr->next;
 		tmp->part_ptr = NULL;
 
-		if (tmp->row) {
+		if (tmp->row && !tmp->rows_shared) {
 			cr_destroy_row_data(tmp->row, tmp->num_rows);
-			tmp->row = NULL;
 		}
+		tmp->row = NULL;
 		xfree(tmp);
 	}
 }
@@ -89,7 +89,9 @@ struct node_use_record {
 	List gres_list;			/* list of gres_node_state_t records as
 					 * defined in in src/common/gres.h.
 					 * Local data used only in state copy
-					 * to emulate future node state */
+					 * to emulate future node state, NULL
+					 * until that copy's gres state is
+					 * first changed */
 	uint16_t node_state;		/* see node_cr_state comments */
 };
 
@@ -108,6 +110,9 @@ struct part_res_record {
 	uint16_t num_rows;		/* Number of elements in "row" array */
 	struct part_record *part_ptr;   /* controller part record pointer */
 	struct part_row_data *row;	/* array of rows containing jobs */
+	bool rows_shared;		/* "row" borrowed from the record this
+					 * was copied from, copy before any
+					 * change (future state copies only) */
 };
 
 /* Global variables */
@@ -132,6 +137,7 @@ extern struct node_res_record *select_node_record;
 extern struct node_use_record *select_node_usage;
 extern struct part_res_record *select_part_record;
 extern bool	select_state_initializing;
+extern int	select_thread_cnt;
 extern bool	spec_cores_first;
 extern bitstr_t **spec_core_res;
 extern bool	topo_optional;
@@ -45,10 +45,42 @@
 #include "src/common/xmalloc.h"
 #include "src/slurmd/slurmd/slurmd.h"
 
+#include <pthread.h>
+
 #ifdef HAVE_NUMA
 #include <numa.h>
 #endif
 
+/*
+ * Cache of computed task binding plans. Steps of the same shape on the same
+ * cores (e.g. repeated srun calls within an allocation) get the same
+ * cpu_bind masks, so the layout is only computed once for each shape.
+ */
+#define LLLP_PLAN_CACHE_SIZE 16
+
+typedef struct {
+	/* Plan key */
+	bitstr_t *avail_map;		/* abstract CPUs of the step */
+	int max_tasks;
+	uint16_t cpus_per_task;
+	uint16_t ntasks_per_core;
+	uint16_t ntasks_per_socket;
+	uint16_t cpu_bind_type;
+	uint32_t task_dist;
+	bool default_dist_block;	/* CR_CORE_DEFAULT_DIST_BLOCK */
+	/* Plan results */
+	char *cpu_bind;
+	uint16_t plan_cpu_bind_type;
+	uint16_t plan_cpus_per_task;
+} lllp_plan_t;
+
+static pthread_mutex_t plan_cache_mutex = PTHREAD_MUTEX_INITIALIZER;
+static lllp_plan_t plan_cache[LLLP_PLAN_CACHE_SIZE];
+static int plan_cache_next = 0;
+static uint16_t *plan_cache_block_map = NULL;
+static uint16_t plan_cache_block_map_size = 0;
+
+
 static char *_alloc_mask(launch_tasks_request_msg_t *req,
 			 int *whole_node_cnt, int *whole_socket_cnt,
 			 int *whole_core_cnt, int *whole_thread_cnt,
@@ -60,9 +92,13 @@ static int _get_local_node_info(slurm_cred_arg_t *arg, int job_node_id,
 				uint16_t *sockets, uint16_t *cores);
 
 static int _task_layout_lllp_block(launch_tasks_request_msg_t *req,
-				   uint32_t node_id, bitstr_t ***masks_p);
+				   uint32_t node_id, bitstr_t ***masks_p,
+				   bitstr_t *avail_map, uint16_t hw_sockets,
+				   uint16_t hw_cores, uint16_t hw_threads);
 static int _task_layout_lllp_cyclic(launch_tasks_request_msg_t *req,
-				    uint32_t node_id, bitstr_t ***masks_p);
+				    uint32_t node_id, bitstr_t ***masks_p,
+				    bitstr_t *avail_map, uint16_t hw_sockets,
+				    uint16_t hw_cores, uint16_t hw_threads);
 
 static void _lllp_map_abstract_masks(const uint32_t maxtasks,
 				     bitstr_t **masks);
@@ -347,6 +383,131 @@ static void _validate_mask(launch_tasks_request_msg_t *req, char *avail_mask)
 	req->cpu_bind = new_mask;
 }
 
+static void _plan_free(lllp_plan_t *plan)
+{
+	FREE_NULL_BITMAP(plan->avail_map);
+	xfree(plan->cpu_bind);
+}
+
+/*
+ * Drop all cached plans if the node's block map changed (i.e. slurmd was
+ * reconfigured with a different CPU layout).
+ * NOTE: Caller must hold plan_cache_mutex
+ */
+static void _plan_cache_validate(void)
+{
+	int i, map_size = conf->block_map_size * sizeof(uint16_t);
+
+	if ((plan_cache_block_map_size == conf->block_map_size) &&
+	    (!conf->block_map ||
+	     !memcmp(plan_cache_block_map, conf->block_map, map_size)))
+		return;
+
+	for (i = 0; i < LLLP_PLAN_CACHE_SIZE; i++)
+		_plan_free(&plan_cache[i]);
+	plan_cache_next = 0;
+	xfree(plan_cache_block_map);
+	plan_cache_block_map_size = conf->block_map_size;
+	if (conf->block_map) {
+		plan_cache_block_map = xmalloc(map_size);
+		memcpy(plan_cache_block_map, conf->block_map, map_size);
+	}
+}
+
+/* Fill in the key of a binding plan from a launch request */
+static void _plan_key(lllp_plan_t *key, launch_tasks_request_msg_t *req,
+		      int max_tasks, bitstr_t *avail_map)
+{
+	memset(key, 0, sizeof(lllp_plan_t));
+	key->avail_map = avail_map;
+	key->max_tasks = max_tasks;
+	key->cpus_per_task = req->cpus_per_task;
+	key->ntasks_per_core = req->ntasks_per_core;
+	key->ntasks_per_socket = req->ntasks_per_socket;
+	key->cpu_bind_type = req->cpu_bind_type;
+	key->task_dist = req->task_dist;
+	key->default_dist_block = (slurm_get_select_type_param() &
+				   CR_CORE_DEFAULT_DIST_BLOCK);
+}
+
+/*
+ * Apply a cached binding plan matching key to req.
+ * RET true if a plan was found, false otherwise
+ */
+static bool _plan_cache_apply(lllp_plan_t *key,
+			      launch_tasks_request_msg_t *req)
+{
+	lllp_plan_t *plan = NULL;
+	char buf_type[100];
+	int i;
+
+	slurm_mutex_lock(&plan_cache_mutex);
+	_plan_cache_validate();
+	for (i = 0; i < LLLP_PLAN_CACHE_SIZE; i++) {
+		lllp_plan_t *p = &plan_cache[i];
+		if (!p->avail_map ||
+		    (p->max_tasks != key->max_tasks) ||
+		    (p->cpus_per_task != key->cpus_per_task) ||
+		    (p->ntasks_per_core != key->ntasks_per_core) ||
+		    (p->ntasks_per_socket != key->ntasks_per_socket) ||
+		    (p->cpu_bind_type != key->cpu_bind_type) ||
+		    (p->task_dist != key->task_dist) ||
+		    (p->default_dist_block != key->default_dist_block) ||
+		    !bit_equal(p->avail_map, key->avail_map))
+			continue;
+		plan = p;
+		break;
+	}
+	if (plan) {
+		xfree(req->cpu_bind);
+		req->cpu_bind = xstrdup(plan->cpu_bind);
+		req->cpu_bind_type = plan->plan_cpu_bind_type;
+		req->cpus_per_task = plan->plan_cpus_per_task;
+	}
+	slurm_mutex_unlock(&plan_cache_mutex);
+
+	if (plan) {
+		slurm_sprint_cpu_bind_type(buf_type, req->cpu_bind_type);
+		info("lllp_distribution jobid [%u] cached binding: %s, %s",
+		     req->job_id, buf_type, req->cpu_bind);
+	}
+
+	return (plan != NULL);
+}
+
+/* Save the binding plan computed for req under key */
+static void _plan_cache_add(lllp_plan_t *key,
+			    launch_tasks_request_msg_t *req)
+{
+	lllp_plan_t *plan;
+
+	slurm_mutex_lock(&plan_cache_mutex);
+	_plan_cache_validate();
+	plan = &plan_cache[plan_cache_next];
+	plan_cache_next = (plan_cache_next + 1) % LLLP_PLAN_CACHE_SIZE;
+	_plan_free(plan);
+	*plan = *key;
+	plan->avail_map = bit_copy(key->avail_map);
+	plan->cpu_bind = xstrdup(req->cpu_bind);
+	plan->plan_cpu_bind_type = req->cpu_bind_type;
+	plan->plan_cpus_per_task = req->cpus_per_task;
+	slurm_mutex_unlock(&plan_cache_mutex);
+}
+
+/* Free all cached binding plans */
+void lllp_distribution_fini(void)
+{
+	int i;
+
+	slurm_mutex_lock(&plan_cache_mutex);
+	for (i = 0; i < LLLP_PLAN_CACHE_SIZE; i++)
+		_plan_free(&plan_cache[i]);
+	plan_cache_next = 0;
+	xfree(plan_cache_block_map);
+	plan_cache_block_map_size = 0;
+	slurm_mutex_unlock(&plan_cache_mutex);
+}
+
 /*
  * lllp_distribution
  *
@@ -372,6 +533,9 @@ void lllp_distribution(launch_tasks_request_msg_t *req, uint32_t node_id)
 	int whole_nodes, whole_sockets, whole_cores, whole_threads;
 	int part_sockets, part_cores;
 	const uint32_t *gtid = req->global_task_ids[(int)node_id];
+	uint16_t hw_sockets = 0, hw_cores = 0, hw_threads = 0;
+	bitstr_t *avail_map;
+	lllp_plan_t plan_key;
 	static uint16_t bind_entity = CPU_BIND_TO_THREADS | CPU_BIND_TO_CORES |
 				      CPU_BIND_TO_SOCKETS | CPU_BIND_TO_LDOMS;
 	static uint16_t bind_mode = CPU_BIND_NONE   | CPU_BIND_MASK   |
@@ -505,20 +669,34 @@ void lllp_distribution(launch_tasks_request_msg_t *req, uint32_t node_id)
 		     req->job_id, buf_type, req->task_dist);
 	}
 
+	avail_map = _get_avail_map(req, &hw_sockets, &hw_cores, &hw_threads);
+	if (!avail_map) {
+		rc = SLURM_ERROR;
+		goto layout_done;
+	}
+
+	_plan_key(&plan_key, req, maxtasks, avail_map);
+	if (_plan_cache_apply(&plan_key, req)) {
+		FREE_NULL_BITMAP(avail_map);
+		return;
+	}
+
 	switch (req->task_dist & SLURM_DIST_STATE_BASE) {
 	case SLURM_DIST_BLOCK_BLOCK:
 	case SLURM_DIST_CYCLIC_BLOCK:
 	case SLURM_DIST_PLANE:
 		/* tasks are distributed in blocks within a plane */
-		rc = _task_layout_lllp_block(req, node_id, &masks);
+		rc = _task_layout_lllp_block(req, node_id, &masks, avail_map,
+					     hw_sockets, hw_cores, hw_threads);
 		break;
 	case SLURM_DIST_ARBITRARY:
 	case SLURM_DIST_BLOCK:
 	case SLURM_DIST_CYCLIC:
 	case SLURM_DIST_UNKNOWN:
-		if (slurm_get_select_type_param()
-		    & CR_CORE_DEFAULT_DIST_BLOCK) {
-			rc = _task_layout_lllp_block(req, node_id, &masks);
+		if (plan_key.default_dist_block) {
+			rc = _task_layout_lllp_block(req, node_id, &masks,
+						     avail_map, hw_sockets,
+						     hw_cores, hw_threads);
 			break;
 		}
 		/*
@@ -526,10 +704,14 @@ void lllp_distribution(launch_tasks_request_msg_t *req, uint32_t node_id)
 		 * default dist block.
 		 */
 	default:
-		rc = _task_layout_lllp_cyclic(req, node_id, &masks);
+		rc = _task_layout_lllp_cyclic(req, node_id, &masks, avail_map,
+					      hw_sockets, hw_cores,
+					      hw_threads);
 		break;
 	}
 
+layout_done:
+
 	/*
 	 * FIXME: I'm worried about core_bitmap with CPU_BIND_TO_SOCKETS &
 	 * max_cores - does select/cons_res plugin allocate whole
@@ -549,6 +731,7 @@ void lllp_distribution(launch_tasks_request_msg_t *req, uint32_t node_id)
 #endif
 	    	 /* convert masks into cpu_bind mask string */
 		 _lllp_generate_cpu_bind(req, maxtasks, masks);
+		_plan_cache_add(&plan_key, req);
 	} else {
 		char *avail_mask = _alloc_mask(req,
 					       &whole_nodes,  &whole_sockets,
@@ -567,6 +750,7 @@ void lllp_distribution(launch_tasks_request_msg_t *req, uint32_t node_id)
 	}
 	if (masks)
 		_lllp_free_masks(maxtasks, masks);
+	FREE_NULL_BITMAP(avail_map);
 }
 
 
@@ -933,29 +1117,25 @@ static void _expand_masks(uint16_t cpu_bind_type, const uint32_t maxtasks,
  *
  */
 static int _task_layout_lllp_cyclic(launch_tasks_request_msg_t *req,
-				    uint32_t node_id, bitstr_t ***masks_p)
+				    uint32_t node_id, bitstr_t ***masks_p,
+				    bitstr_t *avail_map, uint16_t hw_sockets,
+				    uint16_t hw_cores, uint16_t hw_threads)
 {
 	int last_taskcount = -1, taskcount = 0;
-	uint16_t i, s, hw_sockets = 0, hw_cores = 0, hw_threads = 0;
+	uint16_t i, s;
 	uint16_t offset = 0, p = 0;
 	int size, max_tasks = req->tasks_to_launch[(int)node_id];
 	int max_cpus = max_tasks * req->cpus_per_task;
-	bitstr_t *avail_map;
 	bitstr_t **masks = NULL;
 	int *socket_last_pu = NULL;
 	int core_inx, pu_per_core, *core_tasks = NULL;
 
 	info ("_task_layout_lllp_cyclic ");
 
-	avail_map = _get_avail_map(req, &hw_sockets, &hw_cores, &hw_threads);
-	if (!avail_map)
-		return SLURM_ERROR;
-
 	size = bit_set_count(avail_map);
 	if (size < max_tasks) {
 		error("task/affinity: only %d bits in avail_map for %d tasks!",
 		      size, max_tasks);
-		FREE_NULL_BITMAP(avail_map);
 		return SLURM_ERROR;
 	}
 	if (size < max_cpus) {
@@ -1082,7 +1262,6 @@ static int _task_layout_lllp_cyclic(launch_tasks_request_msg_t *req,
 	 * to the requested resource */
 	_expand_masks(req->cpu_bind_type, max_tasks, masks,
 		      hw_sockets, hw_cores, hw_threads, avail_map);
-	FREE_NULL_BITMAP(avail_map);
 	xfree(core_tasks);
 	xfree(socket_last_pu);
 
@@ -1112,36 +1291,29 @@ static int _task_layout_lllp_cyclic(launch_tasks_request_msg_t *req,
  *
  */
 static int _task_layout_lllp_block(launch_tasks_request_msg_t *req,
-				   uint32_t node_id, bitstr_t ***masks_p)
+				   uint32_t node_id, bitstr_t ***masks_p,
+				   bitstr_t *avail_map, uint16_t hw_sockets,
+				   uint16_t hw_cores, uint16_t hw_threads)
 {
 	int c, i, size, last_taskcount = -1, taskcount = 0;
-	uint16_t hw_sockets = 0, hw_cores = 0, hw_threads = 0;
 	int max_tasks = req->tasks_to_launch[(int)node_id];
 	int max_cpus = max_tasks * req->cpus_per_task;
-	bitstr_t *avail_map;
 	bitstr_t **masks = NULL;
 	int core_inx, pu_per_core, *core_tasks = NULL;
 	int sock_inx, pu_per_socket, *socket_tasks = NULL;
 
 	info("_task_layout_lllp_block ");
 
-	avail_map = _get_avail_map(req, &hw_sockets, &hw_cores, &hw_threads);
-	if (!avail_map) {
-		return SLURM_ERROR;
-	}
-
 	size = bit_set_count(avail_map);
 	if ((req->cpu_bind_type & CPU_BIND_ONE_THREAD_PER_CORE) &&
 	    (size < (req->cpus_per_task * hw_threads))) {
 		error("task/affinity: only %d bits in avail_map, CPU_BIND_ONE_THREAD_PER_CORE requires %d!",
 		      size, (req->cpus_per_task * hw_threads));
-		FREE_NULL_BITMAP(avail_map);
 		return SLURM_ERROR;
 	}
 	if (size < max_tasks) {
 		error("task/affinity: only %d bits in avail_map for %d tasks!",
 		      size, max_tasks);
-		FREE_NULL_BITMAP(avail_map);
 		return SLURM_ERROR;
 	}
 	if (size < max_cpus) {
@@ -1240,7 +1412,6 @@ static int _task_layout_lllp_block(launch_tasks_request_msg_t *req,
 	 * to the requested resource */
 	_expand_masks(req->cpu_bind_type, max_tasks, masks,
 			hw_sockets, hw_cores, hw_threads, avail_map);
-	FREE_NULL_BITMAP(avail_map);
 
 	return SLURM_SUCCESS;
 }
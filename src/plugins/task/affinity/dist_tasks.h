@@ -41,5 +41,6 @@
 
 void batch_bind(batch_job_launch_msg_t *req);
 void lllp_distribution(launch_tasks_request_msg_t *req, uint32_t node_id);
+void lllp_distribution_fini(void);
 
 #endif /* !_SLURMSTEPD_DIST_TASKS_H */
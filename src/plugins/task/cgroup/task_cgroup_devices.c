@@ -79,6 +79,10 @@ static void _calc_device_major(char *dev_path[PATH_MAX],
 
 static int _read_allowed_devices_file(char *allowed_devices[PATH_MAX]);
 
+static void _set_device_rules(xcgroup_t *cg, const char *level,
+			      char *allowed_dev_major[PATH_MAX],
+			      int allow_lines, List device_list);
+
 extern int task_cgroup_devices_init(void)
 {
 	uint16_t cpunum;
@@ -193,6 +197,7 @@ extern int task_cgroup_devices_create(stepd_step_rec_t *job)
 	int k, rc, allow_lines = 0;
 	int fstatus = SLURM_ERROR;
 	char *allowed_devices[PATH_MAX], *allowed_dev_major[PATH_MAX];
+	bool step_rules;
 	xcgroup_t devices_cg;
 	uint32_t jobid = job->jobid;
 	uint32_t stepid = job->stepid;
@@ -202,8 +207,6 @@ extern int task_cgroup_devices_create(stepd_step_rec_t *job)
 	List job_gres_list = job->job_gres_list;
 	List step_gres_list = job->step_gres_list;
 	List device_list = NULL;
-	ListIterator itr;
-	gres_device_t *gres_device;
 
 	char* slurm_cgpath ;
 
@@ -313,6 +316,9 @@ extern int task_cgroup_devices_create(stepd_step_rec_t *job)
 		goto error;
 	}
 
+	step_rules = ((job->stepid != SLURM_BATCH_SCRIPT) &&
+		      (job->stepid != SLURM_EXTERN_CONT));
+
 	/*
          * create the entry with major minor for the default allowed devices
          * read from the file
@@ -325,40 +331,14 @@ extern int task_cgroup_devices_create(stepd_step_rec_t *job)
 	/*
 	 * with the current cgroup devices subsystem design (whitelist only
 	 * supported) we need to allow all different devices that are supposed
-	 * to be allowed by* default.
+	 * to be allowed by* default, then allow or deny access to devices
+	 * according to job GRES permissions. The job cgroup may be left over
+	 * from an earlier run of the same job id, so always rewrite its rules.
 	 */
-	for (k = 0; k < allow_lines; k++) {
-		debug2("Default access allowed to device %s for job",
-		       allowed_dev_major[k]);
-		xcgroup_set_param(&job_devices_cg, "devices.allow",
-				  allowed_dev_major[k]);
-	}
-
-	/*
-         * allow or deny access to devices according to job GRES permissions
-         */
 	device_list = gres_plugin_get_allocated_devices(job_gres_list, true);
-
-	if (device_list) {
-		itr = list_iterator_create(device_list);
-		while ((gres_device = list_next(itr))) {
-			if (gres_device->alloc) {
-				debug("Allowing access to device %s(%s) for job",
-				      gres_device->major, gres_device->path);
-				xcgroup_set_param(&job_devices_cg,
-						  "devices.allow",
-						  gres_device->major);
-			} else {
-				debug("Not allowing access to device %s(%s) for job",
-				       gres_device->major, gres_device->path);
-				xcgroup_set_param(&job_devices_cg,
-						  "devices.deny",
-						  gres_device->major);
-			}
-		}
-		list_iterator_destroy(itr);
-		list_destroy(device_list);
-	}
+	_set_device_rules(&job_devices_cg, "job", allowed_dev_major,
+			  allow_lines, device_list);
+	FREE_NULL_LIST(device_list);
 
 	/*
 	 * create step cgroup in the devices ns (it should not exists)
@@ -381,49 +361,18 @@ extern int task_cgroup_devices_create(stepd_step_rec_t *job)
 	}
 
 
-	if ((job->stepid != SLURM_BATCH_SCRIPT) &&
-	    (job->stepid != SLURM_EXTERN_CONT)) {
+	if (step_rules) {
 		/*
 		 * with the current cgroup devices subsystem design (whitelist
 		 * only supported) we need to allow all different devices that
-		 * are supposed to be allowed by default.
-		 */
-		for (k = 0; k < allow_lines; k++) {
-			debug2("Default access allowed to device %s for step",
-			     allowed_dev_major[k]);
-			xcgroup_set_param(&step_devices_cg, "devices.allow",
-					  allowed_dev_major[k]);
-		}
-
-		/*
-		 * allow or deny access to devices according to GRES permissions
-		 * for the step
+		 * are supposed to be allowed by default, then allow or deny
+		 * access to devices according to GRES permissions for the step
 		 */
 		device_list = gres_plugin_get_allocated_devices(
 			step_gres_list, false);
-
-		if (device_list) {
-			itr = list_iterator_create(device_list);
-			while ((gres_device = list_next(itr))) {
-				if (gres_device->alloc) {
-					debug("Allowing access to device %s(%s) for step",
-					      gres_device->major,
-					      gres_device->path);
-					xcgroup_set_param(&step_devices_cg,
-							  "devices.allow",
-							  gres_device->major);
-				} else {
-					debug("Not allowing access to device %s(%s) for step",
-					      gres_device->major,
-					      gres_device->path);
-					xcgroup_set_param(&step_devices_cg,
-							  "devices.deny",
-							  gres_device->major);
-				}
-			}
-			list_iterator_destroy(itr);
-			list_destroy(device_list);
-		}
+		_set_device_rules(&step_devices_cg, "step", allowed_dev_major,
+				  allow_lines, device_list);
+		FREE_NULL_LIST(device_list);
 	}
 	/* attach the slurmstepd to the step devices cgroup */
 	pid_t pid = getpid();
@@ -507,6 +456,62 @@ static int _read_allowed_devices_file(char **allowed_devices)
 }
 
 
+/*
+ * Allow the default devices, then allow or deny each GRES device in
+ * device_list. The rules are written in list order, as later rules
+ * override earlier ones for the same device (e.g. gres/gpu and gres/mps
+ * both list /dev/nvidia0, and an MPS job must keep its GPU allowed).
+ * devices.allow and devices.deny are each opened only once.
+ */
+static void _set_device_rules(xcgroup_t *cg, const char *level,
+			      char *allowed_dev_major[PATH_MAX],
+			      int allow_lines, List device_list)
+{
+	char **param, **rule;
+	int k, rule_cnt = 0, dev_cnt = 0;
+	ListIterator itr;
+	gres_device_t *gres_device;
+
+	if (device_list)
+		dev_cnt = list_count(device_list);
+	param = xmalloc(sizeof(char *) * (allow_lines + dev_cnt + 1));
+	rule = xmalloc(sizeof(char *) * (allow_lines + dev_cnt + 1));
+
+	for (k = 0; k < allow_lines; k++) {
+		if (!allowed_dev_major[k])
+			continue;
+		debug2("Default access allowed to device %s for %s",
+		       allowed_dev_major[k], level);
+		param[rule_cnt] = "devices.allow";
+		rule[rule_cnt++] = allowed_dev_major[k];
+	}
+
+	if (device_list) {
+		itr = list_iterator_create(device_list);
+		while ((gres_device = list_next(itr))) {
+			if (!gres_device->major)
+				continue;
+			if (gres_device->alloc) {
+				debug("Allowing access to device %s(%s) for %s",
+				      gres_device->major, gres_device->path,
+				      level);
+				param[rule_cnt] = "devices.allow";
+			} else {
+				debug("Not allowing access to device %s(%s) for %s",
+				      gres_device->major, gres_device->path,
+				      level);
+				param[rule_cnt] = "devices.deny";
+			}
+			rule[rule_cnt++] = gres_device->major;
+		}
+		list_iterator_destroy(itr);
+	}
+
+	xcgroup_set_param_lines(cg, param, rule, rule_cnt);
+	xfree(param);
+	xfree(rule);
+}
+
 extern int task_cgroup_devices_add_pid(pid_t pid)
 {
 	return xcgroup_add_pids(&step_devices_cg, &pid, 1);
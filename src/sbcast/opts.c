@@ -84,6 +84,7 @@ extern void parse_command_line(int argc, char **argv)
 		{"timeout",   required_argument, 0, 't'},
 		{"verbose",   no_argument,       0, 'v'},
 		{"version",   no_argument,       0, 'V'},
+		{"window",    required_argument, 0, 'W'},
 		{"help",      no_argument,       0, OPT_LONG_HELP},
 		{"usage",     no_argument,       0, OPT_LONG_USAGE},
 		{NULL,        0,                 0, 0}
@@ -119,9 +120,13 @@ extern void parse_command_line(int argc, char **argv)
 		params.block_size = 8 * 1024 * 1024;
 	if ( ( env_val = getenv("SBCAST_TIMEOUT") ) )
 		params.timeout = (atoi(env_val) * 1000);
+	if ( ( env_val = getenv("SBCAST_WINDOW") ) )
+		params.window = atoi(env_val);
+	else
+		params.window = 1;
 
 	optind = 0;
-	while ((opt_char = getopt_long(argc, argv, "CfF:j:ps:t:vV",
+	while ((opt_char = getopt_long(argc, argv, "CfF:j:ps:t:vVW:",
 			long_options, &option_index)) != -1) {
 		switch (opt_char) {
 		case (int)'?':
@@ -162,6 +167,9 @@ extern void parse_command_line(int argc, char **argv)
 		case (int) 'V':
 			print_slurm_version();
 			exit(0);
+		case (int) 'W':
+			params.window = atoi(optarg);
+			break;
 		case (int) OPT_LONG_HELP:
 			_help();
 			exit(0);
@@ -171,6 +179,12 @@ extern void parse_command_line(int argc, char **argv)
 		}
 	}
 
+	if (params.window < 1) {
+		error("Invalid window value (%d), must be at least 1",
+		      params.window);
+		exit(1);
+	}
+
 	if ((argc - optind) != 2) {
 		fprintf(stderr, "Need two file names, have %d names\n",
 			(argc - optind));
@@ -271,6 +285,7 @@ static void _print_options( void )
 	info("preserve   = %s", params.preserve ? "true" : "false");
 	info("timeout    = %d", params.timeout);
 	info("verbose    = %d", params.verbose);
+	info("window     = %d", params.window);
 	info("source     = %s", params.src_fname);
 	info("dest       = %s", params.dst_fname);
 	info("-----------------------------");
@@ -279,7 +294,7 @@ static void _print_options( void )
 
 static void _usage( void )
 {
-	printf("Usage: sbcast [-CfFjpvV] SOURCE DEST\n");
+	printf("Usage: sbcast [-CfFjpvVW] SOURCE DEST\n");
 }
 
 static void _help( void )
@@ -295,6 +310,7 @@ Usage: sbcast [OPTIONS] SOURCE DEST\n\
   -t, --timeout=secs    specify message timeout (seconds)\n\
   -v, --verbose         provide detailed event logging\n\
   -V, --version         print version information and exit\n\
+  -W, --window=num      number of blocks to send in parallel\n\
 \nHelp options:\n\
   --help                show this help message\n\
   --usage               display brief usage message\n");
@@ -69,6 +69,14 @@ typedef struct pack_limits {
 	slurmdb_qos_rec_t *qos_ptr_2;
 } pack_limits_t;
 
+/*
+ * True if the association or QOS has no limit on any TRES in the *_ctld
+ * arrays named by flags (ASSOC_MGR_TRES_*), so checking them can be skipped.
+ * unlimited comes from assoc_mgr_get_{assoc,qos}_tres_unlimited().
+ */
+#define _TRES_UNLIMITED(unlimited, flags) \
+	(((unlimited) & (flags)) == (flags))
+
 /*
  * Update a job's allocated node count to reflect only nodes that are not
  * already allocated to this association.  Needed to enforce GrpNode limit.
@@ -1570,11 +1578,15 @@ static int _qos_policy_validate(job_desc_msg_t *job_desc,
 {
 	int rc = true;
 	int tres_pos = 0;
+	uint32_t qos_unlimited;
 
 	if (!qos_ptr || !qos_out_ptr)
 		return rc;
 
-	if (!_validate_tres_limits_for_qos(&tres_pos,
+	qos_unlimited = assoc_mgr_get_qos_tres_unlimited(qos_ptr);
+
+	if (!_TRES_UNLIMITED(qos_unlimited, ASSOC_MGR_TRES_MAX_PA) &&
+	    !_validate_tres_limits_for_qos(&tres_pos,
 					   job_desc->tres_req_cnt, 0,
 					   NULL,
 					   qos_ptr->max_tres_pa_ctld,
@@ -1602,7 +1614,9 @@ static int _qos_policy_validate(job_desc_msg_t *job_desc,
 		}
 	}
 
-	if (!_validate_tres_limits_for_qos(&tres_pos,
+	if (!_TRES_UNLIMITED(qos_unlimited, ASSOC_MGR_TRES_GRP |
+					    ASSOC_MGR_TRES_MAX_PU) &&
+	    !_validate_tres_limits_for_qos(&tres_pos,
 					   job_desc->tres_req_cnt, 0,
 					   qos_ptr->grp_tres_ctld,
 					   qos_ptr->max_tres_pu_ctld,
@@ -1808,7 +1822,8 @@ static int _qos_policy_validate(job_desc_msg_t *job_desc,
 		}
 	}
 
-	if (!_validate_tres_limits_for_qos(&tres_pos,
+	if (!_TRES_UNLIMITED(qos_unlimited, ASSOC_MGR_TRES_MAX_PJ) &&
+	    !_validate_tres_limits_for_qos(&tres_pos,
 					   job_desc->tres_req_cnt, 0,
 					   NULL,
 					   qos_ptr->max_tres_pj_ctld,
@@ -1833,7 +1848,8 @@ static int _qos_policy_validate(job_desc_msg_t *job_desc,
 		goto end_it;
 	}
 
-	if (!_validate_tres_limits_for_qos(&tres_pos,
+	if (!_TRES_UNLIMITED(qos_unlimited, ASSOC_MGR_TRES_MAX_PN) &&
+	    !_validate_tres_limits_for_qos(&tres_pos,
 					   job_desc->tres_req_cnt,
 					   job_desc->tres_req_cnt[
 						   TRES_ARRAY_NODE],
@@ -1912,7 +1928,8 @@ static int _qos_policy_validate(job_desc_msg_t *job_desc,
 		}
 	}
 
-	if (!_validate_tres_limits_for_qos(&tres_pos,
+	if (!_TRES_UNLIMITED(qos_unlimited, ASSOC_MGR_TRES_MIN_PJ) &&
+	    !_validate_tres_limits_for_qos(&tres_pos,
 					   job_desc->tres_req_cnt, 0,
 					   NULL,
 					   qos_ptr->min_tres_pj_ctld,
@@ -2131,10 +2148,13 @@ static int _qos_job_runnable_post_select(struct job_record *job_ptr,
 	int rc = true, i, tres_pos = 0;
 	acct_policy_tres_usage_t tres_usage;
 	slurmdb_assoc_rec_t *assoc_ptr = job_ptr->assoc_ptr;
+	uint32_t qos_unlimited;
 
 	if (!qos_ptr || !qos_out_ptr || !assoc_ptr)
 		return rc;
 
+	qos_unlimited = assoc_mgr_get_qos_tres_unlimited(qos_ptr);
+
 	/*
 	 * check to see if we should be using safe limits, if so we will only
 	 * will only start a job if there are sufficient remaining cpu-minutes
@@ -2146,11 +2166,15 @@ static int _qos_job_runnable_post_select(struct job_record *job_ptr,
 	/* clang needs this memset to avoid a warning */
 	memset(tres_run_mins, 0, sizeof(tres_run_mins));
 	memset(tres_usage_mins, 0, sizeof(tres_usage_mins));
-	for (i=0; i<slurmctld_tres_cnt; i++) {
-		tres_run_mins[i] =
-			qos_ptr->usage->grp_used_tres_run_secs[i] / 60;
-		tres_usage_mins[i] =
-			(uint64_t)(qos_ptr->usage->usage_tres_raw[i] / 60.0);
+	if (!_TRES_UNLIMITED(qos_unlimited,
+			     ASSOC_MGR_TRES_GRP_MINS |
+			     ASSOC_MGR_TRES_GRP_RUN_MINS)) {
+		for (i = 0; i < slurmctld_tres_cnt; i++) {
+			tres_run_mins[i] =
+				qos_ptr->usage->grp_used_tres_run_secs[i] / 60;
+			tres_usage_mins[i] = (uint64_t)
+				(qos_ptr->usage->usage_tres_raw[i] / 60.0);
+		}
 	}
 
 	used_limits_a =	_get_acct_used_limits(&qos_ptr->usage->acct_limit_list,
@@ -2159,11 +2183,14 @@ static int _qos_job_runnable_post_select(struct job_record *job_ptr,
 	used_limits = _get_user_used_limits(&qos_ptr->usage->user_limit_list,
 					    job_ptr->user_id);
 
-	tres_usage = _validate_tres_usage_limits_for_qos(
-		&tres_pos, qos_ptr->grp_tres_mins_ctld,
-		qos_out_ptr->grp_tres_mins_ctld, job_tres_time_limit,
-		tres_run_mins, tres_usage_mins, job_ptr->limit_set.tres,
-		safe_limits);
+	if (_TRES_UNLIMITED(qos_unlimited, ASSOC_MGR_TRES_GRP_MINS))
+		tres_usage = TRES_USAGE_OKAY;
+	else
+		tres_usage = _validate_tres_usage_limits_for_qos(
+			&tres_pos, qos_ptr->grp_tres_mins_ctld,
+			qos_out_ptr->grp_tres_mins_ctld, job_tres_time_limit,
+			tres_run_mins, tres_usage_mins, job_ptr->limit_set.tres,
+			safe_limits);
 	switch (tres_usage) {
 	case TRES_USAGE_CUR_EXCEEDS_LIMIT:
 		xfree(job_ptr->state_desc);
@@ -2222,15 +2249,20 @@ static int _qos_job_runnable_post_select(struct job_record *job_ptr,
 	 * has a GrpCPU limit, cancel the job if its minimum CPU requirement
 	 * has exceeded the limit for all CPUs usable by the QOS
 	 */
-	orig_node_cnt = tres_req_cnt[TRES_ARRAY_NODE];
-	_get_unique_job_node_cnt(job_ptr, qos_ptr->usage->grp_node_bitmap,
-				 &tres_req_cnt[TRES_ARRAY_NODE]);
-	tres_usage = _validate_tres_usage_limits_for_qos(
-		&tres_pos,
-		qos_ptr->grp_tres_ctld,	qos_out_ptr->grp_tres_ctld,
-		tres_req_cnt, qos_ptr->usage->grp_used_tres,
-		NULL, job_ptr->limit_set.tres, true);
-	tres_req_cnt[TRES_ARRAY_NODE] = orig_node_cnt;
+	if (_TRES_UNLIMITED(qos_unlimited, ASSOC_MGR_TRES_GRP)) {
+		tres_usage = TRES_USAGE_OKAY;
+	} else {
+		orig_node_cnt = tres_req_cnt[TRES_ARRAY_NODE];
+		_get_unique_job_node_cnt(job_ptr,
+					 qos_ptr->usage->grp_node_bitmap,
+					 &tres_req_cnt[TRES_ARRAY_NODE]);
+		tres_usage = _validate_tres_usage_limits_for_qos(
+			&tres_pos,
+			qos_ptr->grp_tres_ctld,	qos_out_ptr->grp_tres_ctld,
+			tres_req_cnt, qos_ptr->usage->grp_used_tres,
+			NULL, job_ptr->limit_set.tres, true);
+		tres_req_cnt[TRES_ARRAY_NODE] = orig_node_cnt;
+	}
 	switch (tres_usage) {
 	case TRES_USAGE_CUR_EXCEEDS_LIMIT:
 		/* not possible because the curr_usage sent in is NULL */
@@ -2266,11 +2298,14 @@ static int _qos_job_runnable_post_select(struct job_record *job_ptr,
 
 	/* we don't need to check grp_jobs here */
 
-	tres_usage = _validate_tres_usage_limits_for_qos(
-		&tres_pos,
-		qos_ptr->grp_tres_run_mins_ctld,
-		qos_out_ptr->grp_tres_run_mins_ctld,
-		job_tres_time_limit, tres_run_mins, NULL, NULL, true);
+	if (_TRES_UNLIMITED(qos_unlimited, ASSOC_MGR_TRES_GRP_RUN_MINS))
+		tres_usage = TRES_USAGE_OKAY;
+	else
+		tres_usage = _validate_tres_usage_limits_for_qos(
+			&tres_pos,
+			qos_ptr->grp_tres_run_mins_ctld,
+			qos_out_ptr->grp_tres_run_mins_ctld,
+			job_tres_time_limit, tres_run_mins, NULL, NULL, true);
 	switch (tres_usage) {
 	case TRES_USAGE_CUR_EXCEEDS_LIMIT:
 		/* not possible because the curr_usage sent in is NULL */
@@ -2309,7 +2344,8 @@ static int _qos_job_runnable_post_select(struct job_record *job_ptr,
 
 	/* we don't need to check grp_wall here */
 
-	if (!_validate_tres_limits_for_qos(&tres_pos,
+	if (!_TRES_UNLIMITED(qos_unlimited, ASSOC_MGR_TRES_MAX_MINS_PJ) &&
+	    !_validate_tres_limits_for_qos(&tres_pos,
 					   job_tres_time_limit, 0,
 					   NULL,
 					   qos_ptr->max_tres_mins_pj_ctld,
@@ -2329,7 +2365,8 @@ static int _qos_job_runnable_post_select(struct job_record *job_ptr,
 		goto end_it;
 	}
 
-	if (!_validate_tres_limits_for_qos(&tres_pos,
+	if (!_TRES_UNLIMITED(qos_unlimited, ASSOC_MGR_TRES_MAX_PJ) &&
+	    !_validate_tres_limits_for_qos(&tres_pos,
 					   tres_req_cnt, 0,
 					   NULL,
 					   qos_ptr->max_tres_pj_ctld,
@@ -2349,7 +2386,8 @@ static int _qos_job_runnable_post_select(struct job_record *job_ptr,
 		goto end_it;
 	}
 
-	if (!_validate_tres_limits_for_qos(&tres_pos,
+	if (!_TRES_UNLIMITED(qos_unlimited, ASSOC_MGR_TRES_MAX_PN) &&
+	    !_validate_tres_limits_for_qos(&tres_pos,
 					   tres_req_cnt,
 					   tres_req_cnt[TRES_ARRAY_NODE],
 					   NULL,
@@ -2374,7 +2412,8 @@ static int _qos_job_runnable_post_select(struct job_record *job_ptr,
 		goto end_it;
 	}
 
-	if (!_validate_tres_limits_for_qos(&tres_pos,
+	if (!_TRES_UNLIMITED(qos_unlimited, ASSOC_MGR_TRES_MIN_PJ) &&
+	    !_validate_tres_limits_for_qos(&tres_pos,
 					   tres_req_cnt, 0,
 					   NULL,
 					   qos_ptr->min_tres_pj_ctld,
@@ -2394,15 +2433,20 @@ static int _qos_job_runnable_post_select(struct job_record *job_ptr,
 		goto end_it;
 	}
 
-	orig_node_cnt = tres_req_cnt[TRES_ARRAY_NODE];
-	_get_unique_job_node_cnt(job_ptr, used_limits_a->node_bitmap,
-				 &tres_req_cnt[TRES_ARRAY_NODE]);
-	tres_usage = _validate_tres_usage_limits_for_qos(
-		&tres_pos,
-		qos_ptr->max_tres_pa_ctld, qos_out_ptr->max_tres_pa_ctld,
-		tres_req_cnt, used_limits_a->tres,
-		NULL, job_ptr->limit_set.tres, true);
-	tres_req_cnt[TRES_ARRAY_NODE] = orig_node_cnt;
+	if (_TRES_UNLIMITED(qos_unlimited, ASSOC_MGR_TRES_MAX_PA)) {
+		tres_usage = TRES_USAGE_OKAY;
+	} else {
+		orig_node_cnt = tres_req_cnt[TRES_ARRAY_NODE];
+		_get_unique_job_node_cnt(job_ptr, used_limits_a->node_bitmap,
+					 &tres_req_cnt[TRES_ARRAY_NODE]);
+		tres_usage = _validate_tres_usage_limits_for_qos(
+			&tres_pos,
+			qos_ptr->max_tres_pa_ctld,
+			qos_out_ptr->max_tres_pa_ctld,
+			tres_req_cnt, used_limits_a->tres,
+			NULL, job_ptr->limit_set.tres, true);
+		tres_req_cnt[TRES_ARRAY_NODE] = orig_node_cnt;
+	}
 	switch (tres_usage) {
 	case TRES_USAGE_CUR_EXCEEDS_LIMIT:
 		/* not possible because the curr_usage sent in is NULL */
@@ -2446,15 +2490,20 @@ static int _qos_job_runnable_post_select(struct job_record *job_ptr,
 		break;
 	}
 
-	orig_node_cnt = tres_req_cnt[TRES_ARRAY_NODE];
-	_get_unique_job_node_cnt(job_ptr, used_limits->node_bitmap,
-				 &tres_req_cnt[TRES_ARRAY_NODE]);
-	tres_usage = _validate_tres_usage_limits_for_qos(
-		&tres_pos,
-		qos_ptr->max_tres_pu_ctld, qos_out_ptr->max_tres_pu_ctld,
-		tres_req_cnt, used_limits->tres,
-		NULL, job_ptr->limit_set.tres, true);
-	tres_req_cnt[TRES_ARRAY_NODE] = orig_node_cnt;
+	if (_TRES_UNLIMITED(qos_unlimited, ASSOC_MGR_TRES_MAX_PU)) {
+		tres_usage = TRES_USAGE_OKAY;
+	} else {
+		orig_node_cnt = tres_req_cnt[TRES_ARRAY_NODE];
+		_get_unique_job_node_cnt(job_ptr, used_limits->node_bitmap,
+					 &tres_req_cnt[TRES_ARRAY_NODE]);
+		tres_usage = _validate_tres_usage_limits_for_qos(
+			&tres_pos,
+			qos_ptr->max_tres_pu_ctld,
+			qos_out_ptr->max_tres_pu_ctld,
+			tres_req_cnt, used_limits->tres,
+			NULL, job_ptr->limit_set.tres, true);
+		tres_req_cnt[TRES_ARRAY_NODE] = orig_node_cnt;
+	}
 	switch (tres_usage) {
 	case TRES_USAGE_CUR_EXCEEDS_LIMIT:
 		/* not possible because the curr_usage sent in is NULL */
@@ -2967,8 +3016,11 @@ static bool _acct_policy_validate(job_desc_msg_t *job_desc,
 
 	while (assoc_ptr) {
 		int tres_pos = 0;
+		uint32_t assoc_unlimited =
+			assoc_mgr_get_assoc_tres_unlimited(assoc_ptr);
 
-		if (!_validate_tres_limits_for_assoc(
+		if (!_TRES_UNLIMITED(assoc_unlimited, ASSOC_MGR_TRES_GRP) &&
+		    !_validate_tres_limits_for_assoc(
 			    &tres_pos, job_desc->tres_req_cnt, 0,
 			    assoc_ptr->grp_tres_ctld,
 			    qos_rec.grp_tres_ctld,
@@ -3107,7 +3159,8 @@ static bool _acct_policy_validate(job_desc_msg_t *job_desc,
 		 */
 
 		tres_pos = 0;
-		if (!_validate_tres_limits_for_assoc(
+		if (!_TRES_UNLIMITED(assoc_unlimited, ASSOC_MGR_TRES_MAX_PJ) &&
+		    !_validate_tres_limits_for_assoc(
 			    &tres_pos, job_desc->tres_req_cnt, 0,
 			    assoc_ptr->max_tres_ctld,
 			    qos_rec.max_tres_pj_ctld,
@@ -3131,7 +3184,8 @@ static bool _acct_policy_validate(job_desc_msg_t *job_desc,
 		}
 
 		tres_pos = 0;
-		if (!_validate_tres_limits_for_assoc(
+		if (!_TRES_UNLIMITED(assoc_unlimited, ASSOC_MGR_TRES_MAX_PN) &&
+		    !_validate_tres_limits_for_assoc(
 			    &tres_pos, job_desc->tres_req_cnt,
 			    job_desc->tres_req_cnt[TRES_ARRAY_NODE],
 			    assoc_ptr->max_tres_pn_ctld,
@@ -3465,8 +3519,10 @@ extern bool acct_policy_job_runnable_pre_select(struct job_record *job_ptr,
 	if (!assoc_mgr_locked)
 		assoc_mgr_lock(&locks);
 
-	assoc_mgr_set_qos_tres_cnt(&qos_rec);
-
+	/*
+	 * No TRES limit is checked before selection, so qos_rec does not need
+	 * its *_ctld arrays built here.
+	 */
 	_set_qos_order(job_ptr, &qos_ptr_1, &qos_ptr_2);
 
 	/* check the first QOS setting it's values in the qos_rec */
@@ -3728,13 +3784,19 @@ extern bool acct_policy_job_runnable_post_select(
 
 	assoc_ptr = job_ptr->assoc_ptr;
 	while (assoc_ptr) {
-		for (i = 0; i < slurmctld_tres_cnt; i++) {
-			tres_usage_mins[i] =
-				(uint64_t)(assoc_ptr->usage->usage_tres_raw[i]
-					   / 60);
-			tres_run_mins[i] =
-				assoc_ptr->usage->grp_used_tres_run_secs[i] /
-				60;
+		uint32_t assoc_unlimited =
+			assoc_mgr_get_assoc_tres_unlimited(assoc_ptr);
+
+		if (!_TRES_UNLIMITED(assoc_unlimited,
+				     ASSOC_MGR_TRES_GRP_MINS |
+				     ASSOC_MGR_TRES_GRP_RUN_MINS)) {
+			for (i = 0; i < slurmctld_tres_cnt; i++) {
+				tres_usage_mins[i] = (uint64_t)
+					(assoc_ptr->usage->usage_tres_raw[i]
+					 / 60);
+				tres_run_mins[i] = assoc_ptr->usage->
+					grp_used_tres_run_secs[i] / 60;
+			}
 		}
 
 #if _DEBUG
@@ -3745,12 +3807,15 @@ extern bool acct_policy_job_runnable_post_select(
 		 * If the association has a GrpCPUMins limit set (and there
 		 * is no QOS with GrpCPUMins set) we may hold the job
 		 */
-		tres_usage = _validate_tres_usage_limits_for_assoc(
-			&tres_pos, assoc_ptr->grp_tres_mins_ctld,
-			qos_rec.grp_tres_mins_ctld,
-			job_tres_time_limit, tres_run_mins,
-			tres_usage_mins, job_ptr->limit_set.tres,
-			safe_limits);
+		if (_TRES_UNLIMITED(assoc_unlimited, ASSOC_MGR_TRES_GRP_MINS))
+			tres_usage = TRES_USAGE_OKAY;
+		else
+			tres_usage = _validate_tres_usage_limits_for_assoc(
+				&tres_pos, assoc_ptr->grp_tres_mins_ctld,
+				qos_rec.grp_tres_mins_ctld,
+				job_tres_time_limit, tres_run_mins,
+				tres_usage_mins, job_ptr->limit_set.tres,
+				safe_limits);
 		switch (tres_usage) {
 		case TRES_USAGE_CUR_EXCEEDS_LIMIT:
 			xfree(job_ptr->state_desc);
@@ -3807,16 +3872,20 @@ extern bool acct_policy_job_runnable_post_select(
 			break;
 		}
 
-		orig_node_cnt = tres_req_cnt[TRES_ARRAY_NODE];
-		_get_unique_job_node_cnt(job_ptr,
-					 assoc_ptr->usage->grp_node_bitmap,
-					 &tres_req_cnt[TRES_ARRAY_NODE]);
-		tres_usage = _validate_tres_usage_limits_for_assoc(
-			&tres_pos,
-			assoc_ptr->grp_tres_ctld, qos_rec.grp_tres_ctld,
-			tres_req_cnt, assoc_ptr->usage->grp_used_tres,
-			NULL, job_ptr->limit_set.tres, true);
-		tres_req_cnt[TRES_ARRAY_NODE] = orig_node_cnt;
+		if (_TRES_UNLIMITED(assoc_unlimited, ASSOC_MGR_TRES_GRP)) {
+			tres_usage = TRES_USAGE_OKAY;
+		} else {
+			orig_node_cnt = tres_req_cnt[TRES_ARRAY_NODE];
+			_get_unique_job_node_cnt(
+				job_ptr, assoc_ptr->usage->grp_node_bitmap,
+				&tres_req_cnt[TRES_ARRAY_NODE]);
+			tres_usage = _validate_tres_usage_limits_for_assoc(
+				&tres_pos,
+				assoc_ptr->grp_tres_ctld, qos_rec.grp_tres_ctld,
+				tres_req_cnt, assoc_ptr->usage->grp_used_tres,
+				NULL, job_ptr->limit_set.tres, true);
+			tres_req_cnt[TRES_ARRAY_NODE] = orig_node_cnt;
+		}
 		switch (tres_usage) {
 		case TRES_USAGE_CUR_EXCEEDS_LIMIT:
 			/* not possible because the curr_usage sent in is NULL*/
@@ -3854,11 +3923,16 @@ extern bool acct_policy_job_runnable_post_select(
 
 		/* we don't need to check grp_jobs here */
 
-		tres_usage = _validate_tres_usage_limits_for_assoc(
-			&tres_pos,
-			assoc_ptr->grp_tres_run_mins_ctld,
-			qos_rec.grp_tres_run_mins_ctld,
-			job_tres_time_limit, tres_run_mins, NULL, NULL, true);
+		if (_TRES_UNLIMITED(assoc_unlimited,
+				    ASSOC_MGR_TRES_GRP_RUN_MINS))
+			tres_usage = TRES_USAGE_OKAY;
+		else
+			tres_usage = _validate_tres_usage_limits_for_assoc(
+				&tres_pos,
+				assoc_ptr->grp_tres_run_mins_ctld,
+				qos_rec.grp_tres_run_mins_ctld,
+				job_tres_time_limit, tres_run_mins,
+				NULL, NULL, true);
 		switch (tres_usage) {
 		case TRES_USAGE_CUR_EXCEEDS_LIMIT:
 			/* not possible because the curr_usage sent in is NULL*/
@@ -3909,7 +3983,9 @@ extern bool acct_policy_job_runnable_post_select(
 			continue;
 		}
 
-		if (!_validate_tres_limits_for_assoc(
+		if (!_TRES_UNLIMITED(assoc_unlimited,
+				     ASSOC_MGR_TRES_MAX_MINS_PJ) &&
+		    !_validate_tres_limits_for_assoc(
 			    &tres_pos, job_tres_time_limit, 0,
 			    assoc_ptr->max_tres_mins_ctld,
 			    qos_rec.max_tres_mins_pj_ctld,
@@ -3928,7 +4004,8 @@ extern bool acct_policy_job_runnable_post_select(
 			goto end_it;
 		}
 
-		if (!_validate_tres_limits_for_assoc(
+		if (!_TRES_UNLIMITED(assoc_unlimited, ASSOC_MGR_TRES_MAX_PJ) &&
+		    !_validate_tres_limits_for_assoc(
 			    &tres_pos, tres_req_cnt, 0,
 			    assoc_ptr->max_tres_ctld,
 			    qos_rec.max_tres_pj_ctld,
@@ -3947,7 +4024,8 @@ extern bool acct_policy_job_runnable_post_select(
 			break;
 		}
 
-		if (!_validate_tres_limits_for_assoc(
+		if (!_TRES_UNLIMITED(assoc_unlimited, ASSOC_MGR_TRES_MAX_PN) &&
+		    !_validate_tres_limits_for_assoc(
 			    &tres_pos, tres_req_cnt,
 			    tres_req_cnt[TRES_ARRAY_NODE],
 			    assoc_ptr->max_tres_pn_ctld,
@@ -4786,3 +4864,41 @@ extern uint32_t acct_policy_get_prio_thresh(struct job_record *job_ptr,
 
 	return prio_thresh;
 }
+
+extern bool acct_policy_job_qos_invalid(struct job_record *job_ptr)
+{
+	assoc_mgr_lock_t locks = { .assoc = READ_LOCK, .qos = READ_LOCK };
+	bool invalid = false;
+
+	if (!(accounting_enforce & ACCOUNTING_ENFORCE_QOS) ||
+	    job_ptr->limit_set.qos)
+		return false;
+
+	/*
+	 * A job found valid under the current association/QOS generation
+	 * stays valid until one of them changes, so don't queue up behind
+	 * an accounting update just to redo the same test.
+	 */
+	if (job_ptr->qos_valid_gen &&
+	    (job_ptr->qos_valid_gen == assoc_mgr_get_conf_gen()) &&
+	    (job_ptr->qos_valid_assoc_id == job_ptr->assoc_id) &&
+	    (job_ptr->qos_valid_qos_id == job_ptr->qos_id))
+		return false;
+
+	assoc_mgr_lock(&locks);
+	if (!job_ptr->assoc_ptr) {
+		job_ptr->qos_valid_gen = 0;
+	} else if ((job_ptr->qos_id >= g_qos_count) ||
+		   !bit_test(job_ptr->assoc_ptr->usage->valid_qos,
+			     job_ptr->qos_id)) {
+		job_ptr->qos_valid_gen = 0;
+		invalid = true;
+	} else {
+		job_ptr->qos_valid_gen = assoc_mgr_get_conf_gen();
+		job_ptr->qos_valid_assoc_id = job_ptr->assoc_id;
+		job_ptr->qos_valid_qos_id = job_ptr->qos_id;
+	}
+	assoc_mgr_unlock(&locks);
+
+	return invalid;
+}
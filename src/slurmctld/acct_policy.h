@@ -174,4 +174,15 @@ extern void acct_policy_remove_accrue_time(struct job_record *job_ptr,
 extern uint32_t acct_policy_get_prio_thresh(struct job_record *job_ptr,
 					    bool assoc_mgr_locked);
 
+/*
+ * acct_policy_job_qos_invalid - Test if the job's QOS is no longer valid for
+ *	its association (e.g. the QOS was removed from the association since
+ *	the job was submitted). The result of a successful test is cached on
+ *	the job and reused until the association or QOS definitions change,
+ *	so the assoc_mgr locks are not taken on every scheduling pass.
+ *	Call without holding the assoc_mgr locks.
+ * RET true if the job can not run with its current QOS
+ */
+extern bool acct_policy_job_qos_invalid(struct job_record *job_ptr);
+
 #endif /* !_HAVE_ACCT_POLICY_H */
@@ -2206,7 +2206,8 @@ static void *_slurmctld_background(void *no_data)
 			last_ctld_bu_ping = now;
 		}
 
-		if (difftime(now, last_trigger) > TRIGGER_INTERVAL) {
+		if ((difftime(now, last_trigger) > TRIGGER_INTERVAL) ||
+		    trigger_event_pending()) {
 			lock_slurmctld(job_node_read_lock);
 			now = time(NULL);
 			last_trigger = now;
@@ -905,6 +905,27 @@ static void _update_all_active_rows(void)
 	list_iterator_destroy(part_iterator);
 }
 
+/* rebuild the active rows of the given partition (if include_self is set)
+ * and of every partition with a lower priority. A job starting or ending in
+ * a partition only changes the shadows cast on lower priority partitions,
+ * so the active rows of higher priority partitions need not be rebuilt */
+static void _update_active_rows_below(struct gs_part *part_ptr,
+				      bool include_self)
+{
+	ListIterator part_iterator;
+	struct gs_part *p_ptr;
+
+	list_sort(gs_part_list, _sort_partitions);
+
+	part_iterator = list_iterator_create(gs_part_list);
+	while ((p_ptr = (struct gs_part *) list_next(part_iterator))) {
+		if ((p_ptr == part_ptr) ? include_self :
+		    (p_ptr->priority < part_ptr->priority))
+			_update_active_row(p_ptr, 1);
+	}
+	list_iterator_destroy(part_iterator);
+}
+
 /* remove the given job from the given partition
  * IN job_id - job to remove
  * IN p_ptr  - GS partition structure
@@ -1247,9 +1268,11 @@ extern void gs_job_start(struct job_record *job_ptr)
 	p_ptr = list_find_first(gs_part_list, _find_gs_part, part_name);
 	if (p_ptr) {
 		job_sig_state = _add_job_to_part(p_ptr, job_ptr);
-		/* if this job is running then check for preemption */
+		/* if this job is running then check for preemption of jobs
+		 * in lower priority partitions, it is already in the active
+		 * row of its own partition */
 		if (job_sig_state == GS_RESUME)
-			_update_all_active_rows();
+			_update_active_rows_below(p_ptr, false);
 	}
 	slurm_mutex_unlock(&data_mutex);
 
@@ -1317,9 +1340,9 @@ extern void gs_job_fini(struct job_record *job_ptr)
 
 	/* remove job from the partition */
 	_remove_job_from_part(job_ptr->job_id, p_ptr, true);
-	/* this job may have preempted other jobs, so
-	 * check by updating all active rows */
-	_update_all_active_rows();
+	/* this job may have preempted other jobs, so check by updating
+	 * the active rows of this and any lower priority partition */
+	_update_active_rows_below(p_ptr, true);
 	slurm_mutex_unlock(&data_mutex);
 	if (slurmctld_conf.debug_flags & DEBUG_FLAG_GANG)
 		info("gang: leaving gs_job_fini");
@@ -1493,27 +1516,28 @@ static void _build_active_row(struct gs_part *p_ptr)
  */
 static void _cycle_job_list(struct gs_part *p_ptr)
 {
-	int i, j;
-	struct gs_job *j_ptr;
+	int i, j, k;
+	struct gs_job *j_ptr, **active_list;
 	uint16_t preempt_mode;
 
 	if (slurmctld_conf.debug_flags & DEBUG_FLAG_GANG)
 		info("gang: entering %s", __func__);
-	/* re-prioritize the job_list and set all row_states to GS_NO_ACTIVE */
-	for (i = 0; i < p_ptr->num_jobs; i++) {
-		while (p_ptr->job_list[i]->row_state == GS_ACTIVE) {
-			/* move this job to the back row and "deactivate" it */
-			j_ptr = p_ptr->job_list[i];
-			j_ptr->row_state = GS_NO_ACTIVE;
-			for (j = i; j+1 < p_ptr->num_jobs; j++) {
-				p_ptr->job_list[j] = p_ptr->job_list[j+1];
-			}
-			p_ptr->job_list[j] = j_ptr;
+	/* re-prioritize the job_list and set all row_states to GS_NO_ACTIVE.
+	 * Active jobs move to the back of the list, preserving their order
+	 * among each other, in a single pass over the list */
+	active_list = xmalloc(sizeof(struct gs_job *) * (p_ptr->num_jobs + 1));
+	for (i = 0, j = 0, k = 0; i < p_ptr->num_jobs; i++) {
+		j_ptr = p_ptr->job_list[i];
+		if (j_ptr->row_state == GS_ACTIVE) {
+			active_list[k++] = j_ptr;
+		} else {
+			p_ptr->job_list[j++] = j_ptr;
 		}
-		if (p_ptr->job_list[i]->row_state == GS_FILLER)
-			p_ptr->job_list[i]->row_state = GS_NO_ACTIVE;
-
+		j_ptr->row_state = GS_NO_ACTIVE;
 	}
+	for (i = 0; i < k; i++)
+		p_ptr->job_list[j++] = active_list[i];
+	xfree(active_list);
 	if (slurmctld_conf.debug_flags & DEBUG_FLAG_GANG)
 		info("gang: %s reordered job list:", __func__);
 	/* Rebuild the active row. */
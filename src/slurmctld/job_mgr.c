@@ -938,6 +938,9 @@ extern int load_all_job_state(void)
 	uint32_t ver_str_len;
 	uint16_t protocol_version = NO_VAL16;
 
+	/* Recovered running jobs must be found by preemption */
+	slurm_preempt_job_reset();
+
 	/* read the file */
 	lock_state_files();
 	if (!(buffer = _open_job_state_file(&state_file))) {
@@ -15163,6 +15166,7 @@ extern void job_completion_logger(struct job_record *job_ptr, bool requeue)
 	xassert(job_ptr);
 
 	acct_policy_remove_job_submit(job_ptr);
+	trigger_job_fini();
 	if (job_ptr->nodes && ((job_ptr->bit_flags & JOB_KILL_HURRY) == 0)
 	    && !IS_JOB_RESIZING(job_ptr)) {
 		(void) bb_g_job_start_stage_out(job_ptr);
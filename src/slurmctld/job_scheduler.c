@@ -71,6 +71,7 @@
 #include "src/common/timers.h"
 #include "src/common/uid.h"
 #include "src/common/xassert.h"
+#include "src/common/xhash.h"
 #include "src/common/xstring.h"
 
 #include "src/slurmctld/acct_policy.h"
@@ -111,6 +112,13 @@ typedef struct wait_boot_arg {
 	bitstr_t *node_bitmap;
 } wait_boot_arg_t;
 
+/* Jobs of one user and job name, as seen by singleton dependencies */
+typedef struct {
+	bool active;		/* a job is running or suspended */
+	char *key;		/* "<user_id>" or "<user_id>/<job name>" */
+	uint32_t min_pend_id;	/* lowest pending job ID, NO_VAL if none */
+} singleton_rec_t;
+
 static char **	_build_env(struct job_record *job_ptr, bool is_epilog);
 static batch_job_launch_msg_t *_build_launch_job_msg(struct job_record *job_ptr,
 						     uint16_t protocol_version);
@@ -148,6 +156,13 @@ static uint16_t bf_hetjob_prio = 0;
 static int sched_min_interval = 2;
 
 static int bb_array_stage_cnt = 10;
+
+/*
+ * Index of singleton_rec_t by user and job name, only valid while
+ * build_job_queue() tests job dependencies, protected by the job write lock.
+ */
+static bool singleton_cache = false;
+static xhash_t *singleton_hash = NULL;
 extern diag_stats_t slurmctld_diag_stats;
 
 /*
@@ -201,36 +216,6 @@ static double _get_system_usage(void)
 	return sys_usage_per;
 }
 
-/*
- * _build_user_job_list - build list of jobs for a given user
- *			  and an optional job name
- * IN  user_id - user id
- * IN  job_name - job name constraint
- * RET the job queue
- * NOTE: the caller must call FREE_NULL_LIST() on RET value to free memory
- */
-static List _build_user_job_list(uint32_t user_id, char* job_name)
-{
-	List job_queue;
-	ListIterator job_iterator;
-	struct job_record *job_ptr = NULL;
-
-	job_queue = list_create(NULL);
-	job_iterator = list_iterator_create(job_list);
-	while ((job_ptr = (struct job_record *) list_next(job_iterator))) {
-		xassert (job_ptr->magic == JOB_MAGIC);
-		if (job_ptr->user_id != user_id)
-			continue;
-		if (job_name && job_ptr->name &&
-		    xstrcmp(job_name, job_ptr->name))
-			continue;
-		list_append(job_queue, job_ptr);
-	}
-	list_iterator_destroy(job_iterator);
-
-	return job_queue;
-}
-
 static void _job_queue_append(List job_queue, struct job_record *job_ptr,
 			      struct part_record *part_ptr, uint32_t prio)
 {
@@ -391,6 +376,192 @@ static bool _job_runnable_test3(struct job_record *job_ptr,
 	return true;
 }
 
+/* Return true if any of the job's dependencies is afterok_correspond */
+static bool _has_depend_correspond(struct job_record *job_ptr)
+{
+	ListIterator depend_iter;
+	struct depend_spec *dep_ptr;
+	bool dep_corr = false;
+
+	if ((job_ptr->details == NULL) ||
+	    (job_ptr->details->depend_list == NULL) ||
+	    (list_count(job_ptr->details->depend_list) == 0))
+		return false;
+
+	depend_iter = list_iterator_create(job_ptr->details->depend_list);
+	while ((dep_ptr = list_next(depend_iter))) {
+		if (dep_ptr->depend_type == SLURM_DEPEND_AFTER_CORRESPOND) {
+			dep_corr = true;
+			break;
+		}
+	}
+	list_iterator_destroy(depend_iter);
+
+	return dep_corr;
+}
+
+/*
+ * Split the first pending task (task_id) out of a job array meta record so it
+ * can be scheduled individually, unless max_pend_cnt tasks are already split.
+ * IN job_ptr - pending job array meta record
+ * IN task_id - first pending task of the array
+ * IN max_pend_cnt - maximum count of individually pending tasks
+ * IN burst_buffer - true to split for burst buffer staging, else for
+ *		     SLURM_DEPEND_AFTER_CORRESPOND
+ * RET false if nothing was done because of max_pend_cnt
+ * NOTE: Messages name the build_job_queue() phase that calls this, and
+ *	 which kind of split (burst buffer or afterok_correspond) it was.
+ */
+static bool _split_pending_array(struct job_record *job_ptr, int task_id,
+				 int max_pend_cnt, bool burst_buffer)
+{
+	struct job_record *new_job_ptr;
+	const char *use = burst_buffer ?
+		"burst buffer" : "SLURM_DEPEND_AFTER_CORRESPOND";
+
+	if (num_pending_job_array_tasks(job_ptr->array_job_id) >= max_pend_cnt)
+		return false;
+	if (job_ptr->array_recs->task_cnt < 1)
+		return true;
+	if (job_ptr->array_recs->task_cnt == 1) {
+		job_ptr->array_task_id = task_id;
+		(void) job_array_post_sched(job_ptr);
+		return true;
+	}
+	job_ptr->array_task_id = task_id;
+	new_job_ptr = job_array_split(job_ptr);
+	if (!new_job_ptr) {
+		error("build_job_queue: Unable to copy record for %pJ for %s use",
+		      job_ptr, use);
+		return true;
+	}
+	if (burst_buffer)
+		debug("build_job_queue: Split out %pJ for %s use",
+		      job_ptr, use);
+	else
+		info("build_job_queue: Split out %pJ for %s use",
+		     job_ptr, use);
+	new_job_ptr->job_state = JOB_PENDING;
+	new_job_ptr->start_time = (time_t) 0;
+	/* Do NOT clear db_index here, it is handled when
+	 * task_id_str is created elsewhere */
+	if (burst_buffer)
+		(void) bb_g_job_validate2(job_ptr, NULL);
+
+	return true;
+}
+
+static void _singleton_rec_id(void *item, const char **key,
+			      uint32_t *key_len)
+{
+	singleton_rec_t *rec = (singleton_rec_t *) item;
+
+	*key = rec->key;
+	*key_len = strlen(rec->key);
+}
+
+static void _singleton_rec_free(void *item)
+{
+	singleton_rec_t *rec = (singleton_rec_t *) item;
+
+	xfree(rec->key);
+	xfree(rec);
+}
+
+static void _singleton_rec_add(char *key, struct job_record *job_ptr)
+{
+	singleton_rec_t *rec;
+
+	if (!(rec = xhash_get_str(singleton_hash, key))) {
+		rec = xmalloc(sizeof(singleton_rec_t));
+		rec->key = xstrdup(key);
+		rec->min_pend_id = NO_VAL;
+		xhash_add(singleton_hash, rec);
+	}
+	if (IS_JOB_RUNNING(job_ptr) || IS_JOB_SUSPENDED(job_ptr))
+		rec->active = true;
+	else if (job_ptr->job_id < rec->min_pend_id)
+		rec->min_pend_id = job_ptr->job_id;
+}
+
+/* Index every pending, running or suspended job by user and job name */
+static void _singleton_hash_build(void)
+{
+	ListIterator job_iterator;
+	struct job_record *job_ptr;
+	char *key = NULL;
+
+	singleton_hash = xhash_init(_singleton_rec_id, _singleton_rec_free);
+	job_iterator = list_iterator_create(job_list);
+	while ((job_ptr = (struct job_record *) list_next(job_iterator))) {
+		if (!IS_JOB_RUNNING(job_ptr) && !IS_JOB_SUSPENDED(job_ptr) &&
+		    !IS_JOB_PENDING(job_ptr))
+			continue;
+		if (job_ptr->name)
+			xstrfmtcat(key, "%u/%s", job_ptr->user_id,
+				   job_ptr->name);
+		else
+			xstrfmtcat(key, "%u", job_ptr->user_id);
+		_singleton_rec_add(key, job_ptr);
+		xfree(key);
+	}
+	list_iterator_destroy(job_iterator);
+}
+
+static bool _singleton_rec_blocks(singleton_rec_t *rec,
+				  struct job_record *job_ptr)
+{
+	return (rec && (rec->active || (rec->min_pend_id < job_ptr->job_id)));
+}
+
+/*
+ * Return true if a singleton dependency of job_ptr is still blocked by
+ * another running, suspended or earlier pending job of the same user with
+ * the same job name (jobs without a name match any name).
+ */
+static bool _singleton_blocked(struct job_record *job_ptr)
+{
+	ListIterator job_iterator;
+	struct job_record *qjob_ptr;
+	char *key = NULL;
+	bool blocked = false;
+
+	if (singleton_cache) {
+		if (!singleton_hash)
+			_singleton_hash_build();
+		xstrfmtcat(key, "%u/%s", job_ptr->user_id, job_ptr->name);
+		blocked = _singleton_rec_blocks(
+			xhash_get_str(singleton_hash, key), job_ptr);
+		xfree(key);
+		if (!blocked) {
+			xstrfmtcat(key, "%u", job_ptr->user_id);
+			blocked = _singleton_rec_blocks(
+				xhash_get_str(singleton_hash, key), job_ptr);
+			xfree(key);
+		}
+		return blocked;
+	}
+
+	job_iterator = list_iterator_create(job_list);
+	while ((qjob_ptr = (struct job_record *) list_next(job_iterator))) {
+		if (qjob_ptr->user_id != job_ptr->user_id)
+			continue;
+		if (qjob_ptr->name && xstrcmp(job_ptr->name, qjob_ptr->name))
+			continue;
+		/* already running/suspended job or previously
+		 * submitted pending job */
+		if (IS_JOB_RUNNING(qjob_ptr) || IS_JOB_SUSPENDED(qjob_ptr) ||
+		    (IS_JOB_PENDING(qjob_ptr) &&
+		     (qjob_ptr->job_id < job_ptr->job_id))) {
+			blocked = true;
+			break;
+		}
+	}
+	list_iterator_destroy(job_iterator);
+
+	return blocked;
+}
+
 /*
  * build_job_queue - build (non-priority ordered) list of pending jobs
  * IN clear_start - if set then clear the start_time for pending jobs,
@@ -403,11 +574,10 @@ extern List build_job_queue(bool clear_start, bool backfill)
 {
 	static time_t last_log_time = 0;
 	List job_queue;
-	ListIterator depend_iter, job_iterator, part_iterator;
-	struct job_record *job_ptr = NULL, *new_job_ptr;
+	ListIterator job_iterator, part_iterator;
+	struct job_record *job_ptr = NULL;
 	struct part_record *part_ptr;
-	struct depend_spec *dep_ptr;
-	int i, pend_cnt, reason, dep_corr;
+	int i, reason;
 	struct timeval start_tv = {0, 0};
 	int tested_jobs = 0;
 	int job_part_pairs = 0;
@@ -417,47 +587,12 @@ extern List build_job_queue(bool clear_start, bool backfill)
 	(void) slurm_delta_tv(&start_tv);
 	job_queue = list_create(_job_queue_rec_del);
 
-	/* Create individual job records for job arrays that need burst buffer
-	 * staging */
-	job_iterator = list_iterator_create(job_list);
-	while ((job_ptr = (struct job_record *) list_next(job_iterator))) {
-		if (!IS_JOB_PENDING(job_ptr) ||
-		    !job_ptr->burst_buffer || !job_ptr->array_recs ||
-		    !job_ptr->array_recs->task_id_bitmap ||
-		    (job_ptr->array_task_id != NO_VAL))
-			continue;
-
-		if ((i = bit_ffs(job_ptr->array_recs->task_id_bitmap)) < 0)
-			continue;
-		pend_cnt = num_pending_job_array_tasks(job_ptr->array_job_id);
-		if (pend_cnt >= bb_array_stage_cnt)
-			continue;
-		if (job_ptr->array_recs->task_cnt < 1)
-			continue;
-		if (job_ptr->array_recs->task_cnt == 1) {
-			job_ptr->array_task_id = i;
-			(void) job_array_post_sched(job_ptr);
-			continue;
-		}
-		job_ptr->array_task_id = i;
-		new_job_ptr = job_array_split(job_ptr);
-		if (new_job_ptr) {
-			debug("%s: Split out %pJ for burst buffer use",
-			      __func__, job_ptr);
-			new_job_ptr->job_state = JOB_PENDING;
-			new_job_ptr->start_time = (time_t) 0;
-			/* Do NOT clear db_index here, it is handled when
-			 * task_id_str is created elsewhere */
-			(void) bb_g_job_validate2(job_ptr, NULL);
-		} else {
-			error("%s: Unable to copy record for %pJ",
-			      __func__, job_ptr);
-		}
-	}
-	list_iterator_destroy(job_iterator);
-
-	/* Create individual job records for job arrays with
-	 * depend_type == SLURM_DEPEND_AFTER_CORRESPOND */
+	/*
+	 * Create individual job records for job arrays that need burst buffer
+	 * staging or use depend_type == SLURM_DEPEND_AFTER_CORRESPOND. Both
+	 * only apply to pending job array meta records, so find them in one
+	 * pass over job_list rather than one pass for each.
+	 */
 	job_iterator = list_iterator_create(job_list);
 	while ((job_ptr = (struct job_record *) list_next(job_iterator))) {
 		if (!IS_JOB_PENDING(job_ptr) ||
@@ -467,48 +602,22 @@ extern List build_job_queue(bool clear_start, bool backfill)
 			continue;
 		if ((i = bit_ffs(job_ptr->array_recs->task_id_bitmap)) < 0)
 			continue;
-		if ((job_ptr->details == NULL) ||
-		    (job_ptr->details->depend_list == NULL) ||
-		    (list_count(job_ptr->details->depend_list) == 0))
+		if (job_ptr->burst_buffer &&
+		    _split_pending_array(job_ptr, i, bb_array_stage_cnt, true))
 			continue;
-		depend_iter = list_iterator_create(
-			job_ptr->details->depend_list);
-		dep_corr = 0;
-		while ((dep_ptr = list_next(depend_iter))) {
-			if (dep_ptr->depend_type ==
-			    SLURM_DEPEND_AFTER_CORRESPOND) {
-				dep_corr = 1;
-				break;
-			}
-		}
-		if (!dep_corr)
-			continue;
-		pend_cnt = num_pending_job_array_tasks(job_ptr->array_job_id);
-		if (pend_cnt >= CORRESPOND_ARRAY_TASK_CNT)
-			continue;
-		if (job_ptr->array_recs->task_cnt < 1)
-			continue;
-		if (job_ptr->array_recs->task_cnt == 1) {
-			job_ptr->array_task_id = i;
-			(void) job_array_post_sched(job_ptr);
-			continue;
-		}
-		job_ptr->array_task_id = i;
-		new_job_ptr = job_array_split(job_ptr);
-		if (new_job_ptr) {
-			info("%s: Split out %pJ for SLURM_DEPEND_AFTER_CORRESPOND use",
-			     __func__, job_ptr);
-			new_job_ptr->job_state = JOB_PENDING;
-			new_job_ptr->start_time = (time_t) 0;
-			/* Do NOT clear db_index here, it is handled when
-			 * task_id_str is created elsewhere */
-		} else {
-			error("%s: Unable to copy record for %pJ",
-			      __func__, job_ptr);
-		}
+		if (_has_depend_correspond(job_ptr))
+			(void) _split_pending_array(job_ptr, i,
+						    CORRESPOND_ARRAY_TASK_CNT,
+						    false);
 	}
 	list_iterator_destroy(job_iterator);
 
+	/*
+	 * No job is started while the queue is built, so singleton
+	 * dependencies can all be tested against one index of the job list
+	 * instead of a job_list scan for each pending job.
+	 */
+	singleton_cache = true;
 	job_iterator = list_iterator_create(job_list);
 	while ((job_ptr = (struct job_record *) list_next(job_iterator))) {
 		if (IS_JOB_PENDING(job_ptr))
@@ -601,6 +710,8 @@ extern List build_job_queue(bool clear_start, bool backfill)
 		}
 	}
 	list_iterator_destroy(job_iterator);
+	singleton_cache = false;
+	xhash_free(singleton_hash);
 
 	return job_queue;
 }
@@ -1496,28 +1607,17 @@ next_task:
 			}
 		}
 		if (job_ptr->qos_id) {
-			assoc_mgr_lock_t locks =
-				{ .assoc = READ_LOCK, .qos = READ_LOCK };
-
-			assoc_mgr_lock(&locks);
-			if (job_ptr->assoc_ptr
-			    && (accounting_enforce & ACCOUNTING_ENFORCE_QOS)
-			    && ((job_ptr->qos_id >= g_qos_count) ||
-				!bit_test(job_ptr->assoc_ptr->usage->valid_qos,
-					  job_ptr->qos_id))
-			    && !job_ptr->limit_set.qos) {
+			if (acct_policy_job_qos_invalid(job_ptr)) {
 				sched_debug("%pJ has invalid QOS", job_ptr);
 				xfree(job_ptr->state_desc);
 				job_ptr->state_reason = FAIL_QOS;
 				last_job_update = now;
-				assoc_mgr_unlock(&locks);
 				continue;
 			} else if (job_ptr->state_reason == FAIL_QOS) {
 				xfree(job_ptr->state_desc);
 				job_ptr->state_reason = WAIT_NO_REASON;
 				last_job_update = now;
 			}
-			assoc_mgr_unlock(&locks);
 		}
 
 		deadline_time_limit = 0;
@@ -2678,14 +2778,12 @@ static void _depend_list2str(struct job_record *job_ptr, bool set_or_flag)
  */
 extern int test_job_dependency(struct job_record *job_ptr)
 {
-	ListIterator depend_iter, job_iterator;
+	ListIterator depend_iter;
 	struct depend_spec *dep_ptr;
 	bool failure = false, depends = false, rebuild_str = false;
 	bool or_satisfied = false;
-	List job_queue = NULL;
-	bool run_now;
 	int results = 0;
-	struct job_record *qjob_ptr, *djob_ptr, *dcjob_ptr;
+	struct job_record *djob_ptr, *dcjob_ptr;
 
 	if ((job_ptr->details == NULL) ||
 	    (job_ptr->details->depend_list == NULL) ||
@@ -2700,27 +2798,8 @@ extern int test_job_dependency(struct job_record *job_ptr)
 		djob_ptr = dep_ptr->job_ptr;
 		if ((dep_ptr->depend_type == SLURM_DEPEND_SINGLETON) &&
 		    job_ptr->name) {
-			/* get user jobs with the same user and name */
-			job_queue = _build_user_job_list(job_ptr->user_id,
-							 job_ptr->name);
-			run_now = true;
-			job_iterator = list_iterator_create(job_queue);
-			while ((qjob_ptr = (struct job_record *)
-				list_next(job_iterator))) {
-				/* already running/suspended job or previously
-				 * submitted pending job */
-				if (IS_JOB_RUNNING(qjob_ptr) ||
-				    IS_JOB_SUSPENDED(qjob_ptr) ||
-				    (IS_JOB_PENDING(qjob_ptr) &&
-				     (qjob_ptr->job_id < job_ptr->job_id))) {
-					run_now = false;
-					break;
-				}
-			}
-			list_iterator_destroy(job_iterator);
-			FREE_NULL_LIST(job_queue);
 			/* job can run now, delete dependency */
-			if (run_now)
+			if (!_singleton_blocked(job_ptr))
 				list_delete_item(depend_iter);
 			else
 				depends = true;
@@ -48,6 +48,7 @@
 #include "src/common/list.h"
 #include "src/common/log.h"
 #include "src/common/macros.h"
+#include "src/common/xhash.h"
 #include "src/common/xmalloc.h"
 #include "src/common/xstring.h"
 #include "src/slurmctld/licenses.h"
@@ -58,6 +59,9 @@
 List license_list = (List) NULL;
 time_t last_license_update = 0;
 static pthread_mutex_t license_mutex = PTHREAD_MUTEX_INITIALIZER;
+/* Index of license_list by name, rebuilt on next use when invalidated */
+static xhash_t *license_hash = NULL;
+static bool license_hash_valid = false;
 static void _pack_license(struct licenses *lic, Buf buffer, uint16_t protocol_version);
 
 /* Print all licenses on a list */
@@ -110,6 +114,44 @@ static int _license_find_rec(void *x, void *key)
 	return 1;
 }
 
+static void _license_hash_id(void *item, const char **key, uint32_t *key_len)
+{
+	licenses_t *license_entry = (licenses_t *) item;
+
+	*key = license_entry->name;
+	*key_len = strlen(license_entry->name);
+}
+
+/*
+ * Find a license_t record in license_list by license name, using an index
+ * rather than a search of the list.
+ * license_mutex should be locked before calling this.
+ */
+static licenses_t *_license_find(char *name)
+{
+	ListIterator iter;
+	licenses_t *license_entry;
+
+	if (!license_list || !name)
+		return NULL;
+
+	if (!license_hash_valid) {
+		xhash_free(license_hash);
+		license_hash = xhash_init(_license_hash_id, NULL);
+		iter = list_iterator_create(license_list);
+		while ((license_entry = (licenses_t *) list_next(iter))) {
+			/* First record of a name in the list is used */
+			if (license_entry->name &&
+			    !xhash_get_str(license_hash, license_entry->name))
+				xhash_add(license_hash, license_entry);
+		}
+		list_iterator_destroy(iter);
+		license_hash_valid = true;
+	}
+
+	return xhash_get_str(license_hash, name);
+}
+
 /* Find a license_t record by license name (for use by list_find_first) */
 static int _license_find_remote_rec(void *x, void *key)
 {
@@ -223,6 +265,7 @@ static void _add_res_rec_2_lic_list(slurmdb_res_rec_t *rec, bool sync)
 	license_entry->remote = sync ? 2 : 1;
 
 	list_push(license_list, license_entry);
+	license_hash_valid = false;
 	last_license_update = time(NULL);
 }
 
@@ -265,6 +308,7 @@ extern int license_init(char *licenses)
 	license_list = _build_license_list(licenses, &valid);
 	if (!valid)
 		fatal("Invalid configured licenses: %s", licenses);
+	license_hash_valid = false;
 
 	_licenses_print("init_license", license_list, NULL);
 	slurm_mutex_unlock(&license_mutex);
@@ -287,6 +331,7 @@ extern int license_update(char *licenses)
         slurm_mutex_lock(&license_mutex);
         if (!license_list) {        /* no licenses before now */
                 license_list = new_list;
+                license_hash_valid = false;
                 slurm_mutex_unlock(&license_mutex);
                 return SLURM_SUCCESS;
         }
@@ -323,6 +368,7 @@ extern int license_update(char *licenses)
 
         FREE_NULL_LIST(license_list);
         license_list = new_list;
+        license_hash_valid = false;
         _licenses_print("update_license", license_list, NULL);
         slurm_mutex_unlock(&license_mutex);
         return SLURM_SUCCESS;
@@ -432,6 +478,7 @@ extern void license_remove_remote(slurmdb_res_rec_t *rec)
 			     "removed with %u in use",
 			     license_entry->name, license_entry->used);
 			list_delete_item(iter);
+			license_hash_valid = false;
 			last_license_update = time(NULL);
 			break;
 		}
@@ -500,6 +547,7 @@ extern void license_sync_remote(List res_list)
 			     "removed with %u in use",
 			     license_entry->name, license_entry->used);
 			list_delete_item(iter);
+			license_hash_valid = false;
 			last_license_update = time(NULL);
 		} else if (license_entry->remote == 2)
 			license_entry->remote = 1;
@@ -514,6 +562,8 @@ extern void license_free(void)
 {
 	slurm_mutex_lock(&license_mutex);
 	FREE_NULL_LIST(license_list);
+	xhash_free(license_hash);
+	license_hash_valid = false;
 	slurm_mutex_unlock(&license_mutex);
 }
 
@@ -557,12 +607,7 @@ extern List license_validate(char *licenses, bool validate_configured,
 	_licenses_print("request_license", job_license_list, NULL);
 	iter = list_iterator_create(job_license_list);
 	while ((license_entry = (licenses_t *) list_next(iter))) {
-		if (license_list) {
-			match = list_find_first(license_list,
-						_license_find_rec,
-						license_entry->name);
-		} else
-			match = NULL;
+		match = _license_find(license_entry->name);
 		if (!match) {
 			debug("License name requested (%s) does not exist",
 			      license_entry->name);
@@ -634,8 +679,7 @@ extern int license_job_test(struct job_record *job_ptr, time_t when,
 	slurm_mutex_lock(&license_mutex);
 	iter = list_iterator_create(job_ptr->license_list);
 	while ((license_entry = (licenses_t *) list_next(iter))) {
-		match = list_find_first(license_list, _license_find_rec,
-			license_entry->name);
+		match = _license_find(license_entry->name);
 		if (!match) {
 			error("could not find license %s for job %u",
 			      license_entry->name, job_ptr->job_id);
@@ -713,8 +757,7 @@ extern int license_job_get(struct job_record *job_ptr)
 	slurm_mutex_lock(&license_mutex);
 	iter = list_iterator_create(job_ptr->license_list);
 	while ((license_entry = (licenses_t *) list_next(iter))) {
-		match = list_find_first(license_list, _license_find_rec,
-			license_entry->name);
+		match = _license_find(license_entry->name);
 		if (match) {
 			match->used += license_entry->total;
 			license_entry->used += license_entry->total;
@@ -749,8 +792,7 @@ extern int license_job_return(struct job_record *job_ptr)
 	slurm_mutex_lock(&license_mutex);
 	iter = list_iterator_create(job_ptr->license_list);
 	while ((license_entry = (licenses_t *) list_next(iter))) {
-		match = list_find_first(license_list, _license_find_rec,
-			license_entry->name);
+		match = _license_find(license_entry->name);
 		if (match) {
 			if (match->used >= license_entry->total)
 				match->used -= license_entry->total;
@@ -862,8 +904,7 @@ extern uint32_t get_total_license_cnt(char *name)
 
 	slurm_mutex_lock(&license_mutex);
 	if (license_list) {
-		lic = list_find_first(
-			license_list, _license_find_rec, name);
+		lic = _license_find(name);
 
 		if (lic)
 			count = lic->total;
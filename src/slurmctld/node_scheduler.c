@@ -81,6 +81,7 @@
 #include "src/slurmctld/powercapping.h"
 #include "src/slurmctld/preempt.h"
 #include "src/slurmctld/proc_req.h"
+#include "src/slurmctld/read_config.h"
 #include "src/slurmctld/reservation.h"
 #include "src/slurmctld/slurmctld.h"
 #include "src/slurmctld/slurmctld_plugstack.h"
@@ -646,6 +647,8 @@ extern void deallocate_nodes(struct job_record *job_ptr, bool timeout,
  * For every element in the feature_list, identify the nodes with that feature
  * either active or available and set the feature_list's node_bitmap_active and
  * node_bitmap_avail fields accordingly.
+ * Bitmaps already built against the current feature_list_gen with the same
+ * can_reboot value are reused rather than rebuilt.
  */
 extern void find_feature_nodes(List feature_list, bool can_reboot)
 {
@@ -657,11 +660,17 @@ extern void find_feature_nodes(List feature_list, bool can_reboot)
 		return;
 	feat_iter = list_iterator_create(feature_list);
 	while ((job_feat_ptr = (job_feature_t *) list_next(feat_iter))) {
+		if ((job_feat_ptr->feature_gen == feature_list_gen) &&
+		    (job_feat_ptr->feature_reboot == can_reboot) &&
+		    job_feat_ptr->node_bitmap_active &&
+		    job_feat_ptr->node_bitmap_avail)
+			continue;
+		job_feat_ptr->feature_gen = feature_list_gen;
+		job_feat_ptr->feature_reboot = can_reboot;
 		FREE_NULL_BITMAP(job_feat_ptr->node_bitmap_active);
 		FREE_NULL_BITMAP(job_feat_ptr->node_bitmap_avail);
-		node_feat_ptr = list_find_first(active_feature_list,
-						list_find_feature,
-						job_feat_ptr->name);
+		node_feat_ptr = find_feature_record(active_feature_list,
+						    job_feat_ptr->name);
 		if (node_feat_ptr && node_feat_ptr->node_bitmap) {
 			job_feat_ptr->node_bitmap_active =
 				bit_copy(node_feat_ptr->node_bitmap);
@@ -670,9 +679,8 @@ extern void find_feature_nodes(List feature_list, bool can_reboot)
 				bit_alloc(node_record_count);
 		}
 		if (can_reboot && job_feat_ptr->changeable) {
-			node_feat_ptr = list_find_first(avail_feature_list,
-							list_find_feature,
-							job_feat_ptr->name);
+			node_feat_ptr = find_feature_record(avail_feature_list,
+							    job_feat_ptr->name);
 			if (node_feat_ptr && node_feat_ptr->node_bitmap) {
 				job_feat_ptr->node_bitmap_avail =
 					bit_copy(node_feat_ptr->node_bitmap);
@@ -856,8 +864,8 @@ extern bitstr_t *build_active_feature_bitmap2(char *reboot_features)
 	sep = strchr(tmp, ',');
 	if (sep) {
 		sep[0] = '\0';
-		node_feat_ptr = list_find_first(active_feature_list,
-						list_find_feature, sep + 1);
+		node_feat_ptr = find_feature_record(active_feature_list,
+						    sep + 1);
 		if (node_feat_ptr && node_feat_ptr->node_bitmap) {
 			active_node_bitmap =
 				bit_copy(node_feat_ptr->node_bitmap);
@@ -865,8 +873,7 @@ extern bitstr_t *build_active_feature_bitmap2(char *reboot_features)
 			active_node_bitmap = bit_alloc(node_record_count);
 		}
 	}
-	node_feat_ptr = list_find_first(active_feature_list, list_find_feature,
-					tmp);
+	node_feat_ptr = find_feature_record(active_feature_list, tmp);
 	if (node_feat_ptr && node_feat_ptr->node_bitmap) {
 		if (active_node_bitmap) {
 			bit_and(active_node_bitmap, node_feat_ptr->node_bitmap);
@@ -2981,6 +2988,7 @@ extern int select_nodes(struct job_record *job_ptr, bool test_only,
 
 	job_ptr->job_state = JOB_RUNNING;
 	job_ptr->bit_flags |= JOB_WAS_RUNNING;
+	slurm_preempt_job_start(job_ptr);
 
 	if (select_g_select_nodeinfo_set(job_ptr) != SLURM_SUCCESS) {
 		error("select_g_select_nodeinfo_set(%pJ): %m", job_ptr);
@@ -4435,7 +4443,6 @@ extern int pick_batch_host(struct job_record *job_ptr)
 	struct node_record *node_ptr;
 	char *tmp, *tok, sep, last_sep = '&';
 	node_feature_t *feature_ptr;
-	ListIterator feature_iter;
 	bitstr_t *feature_bitmap;
 
 	if (job_ptr->batch_host)
@@ -4472,23 +4479,13 @@ extern int pick_batch_host(struct job_record *job_ptr)
 			continue;
 		tmp[i] = '\0';
 
-		feature_iter = list_iterator_create(active_feature_list);
-		while ((feature_ptr = (node_feature_t *)
-				      list_next(feature_iter))) {
-			if (xstrcmp(feature_ptr->name, tok))
-				continue;
-			if (last_sep == '&') {
-				bit_and(feature_bitmap,
-					feature_ptr->node_bitmap);
-			} else {
-				bit_or(feature_bitmap,
-				       feature_ptr->node_bitmap);
-			}
-			break;
-		}
-		list_iterator_destroy(feature_iter);
+		feature_ptr = find_feature_record(active_feature_list, tok);
 		if (!feature_ptr)	/* No match */
 			bit_clear_all(feature_bitmap);
+		else if (last_sep == '&')
+			bit_and(feature_bitmap, feature_ptr->node_bitmap);
+		else
+			bit_or(feature_bitmap, feature_ptr->node_bitmap);
 		if (sep == '\0')
 			break;
 		tok = tmp + i + 1;
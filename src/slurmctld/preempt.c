@@ -43,6 +43,7 @@
 #include "src/common/log.h"
 #include "src/common/plugrack.h"
 #include "src/common/slurm_protocol_api.h"
+#include "src/common/xhash.h"
 #include "src/common/xmalloc.h"
 #include "src/common/xstring.h"
 #include "src/slurmctld/slurmctld.h"
@@ -71,6 +72,17 @@ static plugin_context_t *g_context = NULL;
 static pthread_mutex_t	    g_context_lock = PTHREAD_MUTEX_INITIALIZER;
 static bool init_run = false;
 
+/*
+ * Job IDs of running and suspended jobs, the only jobs which can be
+ * preempted. Built from job_list on first use, then extended as jobs are
+ * allocated resources. IDs of jobs which have since ended are removed when
+ * the list is next read. active_job_hash indexes the same records by job ID
+ * and both are discarded whenever job state is loaded.
+ */
+static List active_job_list = NULL;
+static xhash_t *active_job_hash = NULL;
+static pthread_mutex_t active_job_mutex = PTHREAD_MUTEX_INITIALIZER;
+
 static void _preempt_signal(struct job_record *job_ptr, uint32_t grace_time)
 {
 	if (job_ptr->preempt_time)
@@ -132,6 +144,61 @@ extern int slurm_job_check_grace(struct job_record *job_ptr,
 	return rc;
 }
 
+static void _active_job_del(void *x)
+{
+	xfree(x);
+}
+
+static void _active_job_id(void *item, const char **key, uint32_t *key_len)
+{
+	*key = (const char *) item;
+	*key_len = sizeof(uint32_t);
+}
+
+static bool _is_job_active(struct job_record *job_ptr)
+{
+	if (job_ptr && (IS_JOB_RUNNING(job_ptr) || IS_JOB_SUSPENDED(job_ptr)))
+		return true;
+	return false;
+}
+
+static void _active_job_add(uint32_t job_id)
+{
+	uint32_t *job_id_ptr = xmalloc(sizeof(uint32_t));
+
+	*job_id_ptr = job_id;
+	list_append(active_job_list, job_id_ptr);
+	xhash_add(active_job_hash, job_id_ptr);
+}
+
+static int _active_job_ended(void *x, void *key)
+{
+	uint32_t *job_id = (uint32_t *) x;
+
+	if (_is_job_active(find_job_record(*job_id)))
+		return 0;
+	xhash_delete(active_job_hash, (char *) job_id, sizeof(uint32_t));
+	return 1;
+}
+
+/* Discard the index of active jobs. NOTE: Caller must hold active_job_mutex */
+static void _active_job_free(void)
+{
+	xhash_free(active_job_hash);
+	FREE_NULL_LIST(active_job_list);
+}
+
+static int _active_job_append(void *x, void *arg)
+{
+	uint32_t *job_id = (uint32_t *) x;
+	List job_ptr_list = (List) arg;
+	struct job_record *job_ptr = find_job_record(*job_id);
+
+	if (_is_job_active(job_ptr))
+		list_append(job_ptr_list, job_ptr);
+	return 0;
+}
+
 extern int slurm_preempt_init(void)
 {
 	int retval = SLURM_SUCCESS;
@@ -174,6 +241,9 @@ extern int slurm_preempt_fini(void)
 		return SLURM_SUCCESS;
 
 	init_run = false;
+	slurm_mutex_lock(&active_job_mutex);
+	_active_job_free();
+	slurm_mutex_unlock(&active_job_mutex);
 	rc = plugin_context_destroy(g_context);
 	g_context = NULL;
 	return rc;
@@ -221,3 +291,63 @@ extern bool slurm_job_preempt_check(job_queue_rec_t *preemptor,
 	return (*(ops.job_preempt_check))
 		(preemptor, preemptee);
 }
+
+/*
+ * Return a list of pointers to running and suspended jobs, which are the
+ * only jobs that can be preempted, without scanning all of job_list.
+ * NOTE: Caller must hold a job lock and list_destroy() the list returned.
+ */
+extern List slurm_preempt_active_jobs(void)
+{
+	ListIterator job_iterator;
+	struct job_record *job_ptr;
+	List job_ptr_list = list_create(NULL);
+
+	slurm_mutex_lock(&active_job_mutex);
+	if (!active_job_list) {
+		active_job_list = list_create(_active_job_del);
+		active_job_hash = xhash_init(_active_job_id, NULL);
+		job_iterator = list_iterator_create(job_list);
+		while ((job_ptr = (struct job_record *)
+				  list_next(job_iterator))) {
+			if (_is_job_active(job_ptr))
+				_active_job_add(job_ptr->job_id);
+		}
+		list_iterator_destroy(job_iterator);
+	} else {
+		(void) list_delete_all(active_job_list, _active_job_ended,
+				       NULL);
+	}
+	(void) list_for_each(active_job_list, _active_job_append,
+			     job_ptr_list);
+	slurm_mutex_unlock(&active_job_mutex);
+
+	return job_ptr_list;
+}
+
+/*
+ * Note that a job has been allocated resources so that it is included in
+ * the list returned by slurm_preempt_active_jobs().
+ * NOTE: Caller must hold a job write lock.
+ */
+extern void slurm_preempt_job_start(struct job_record *job_ptr)
+{
+	slurm_mutex_lock(&active_job_mutex);
+	/* The list is built on first use */
+	if (active_job_list &&
+	    !xhash_get(active_job_hash, (char *) &job_ptr->job_id,
+		       sizeof(uint32_t)))
+		_active_job_add(job_ptr->job_id);
+	slurm_mutex_unlock(&active_job_mutex);
+}
+
+/*
+ * Discard the list of active jobs, it is rebuilt from job_list on next use.
+ * NOTE: Call whenever job_list is (re)loaded from saved state.
+ */
+extern void slurm_preempt_job_reset(void)
+{
+	slurm_mutex_lock(&active_job_mutex);
+	_active_job_free();
+	slurm_mutex_unlock(&active_job_mutex);
+}
@@ -90,6 +90,26 @@ extern bool slurm_job_preempt_check(job_queue_rec_t *preemptor,
 				    job_queue_rec_t *preemptee);
 
 
+/*
+ * Return a list of pointers to running and suspended jobs, which are the
+ * only jobs that can be preempted, without scanning all of job_list.
+ * NOTE: Caller must hold a job lock and list_destroy() the list returned.
+ */
+extern List slurm_preempt_active_jobs(void);
+
+/*
+ * Note that a job has been allocated resources so that it is included in
+ * the list returned by slurm_preempt_active_jobs().
+ * NOTE: Caller must hold a job write lock.
+ */
+extern void slurm_preempt_job_start(struct job_record *job_ptr);
+
+/*
+ * Discard the list of active jobs, it is rebuilt from job_list on next use.
+ * NOTE: Call whenever job_list is (re)loaded from saved state.
+ */
+extern void slurm_preempt_job_reset(void);
+
 /* Returns a Slurm errno if preempt grace isn't allowed */
 extern int slurm_job_check_grace(struct job_record *job_ptr,
 				 struct job_record *preemptor_ptr);
@@ -97,6 +97,7 @@
 /* Global variables */
 List active_feature_list;	/* list of currently active features_records */
 List avail_feature_list;	/* list of available features_records */
+uint32_t feature_list_gen = 1;	/* changes with feature list contents */
 bool node_features_updated = false;
 bool slurmctld_init_db = true;
 
@@ -112,6 +113,7 @@ static int  _compare_hostnames(struct node_record *old_node_table,
 			       struct node_record *node_table, int node_count);
 static void _gres_reconfig(bool reconfig);
 static int  _init_all_slurm_conf(void);
+static void _feature_hash_build(List feature_list);
 static void _list_delete_feature(void *feature_entry);
 static int  _preserve_select_type_param(slurm_ctl_conf_t * ctl_conf_ptr,
 					uint16_t old_select_type_p);
@@ -126,6 +128,9 @@ static void _purge_old_part_state(List old_part_list, char *old_def_part_name);
 static int  _reset_node_bitmaps(void *x, void *arg);
 static int  _restore_job_dependencies(void);
 
+static xhash_t *active_feature_hash = NULL;
+static xhash_t *avail_feature_hash = NULL;
+
 static int  _restore_node_state(int recover,
 				struct node_record *old_node_table_ptr,
 				int old_node_record_count);
@@ -1548,6 +1553,77 @@ static void _add_config_feature_inx(List feature_list, char *feature,
 	}
 }
 
+static void _feature_hash_id(void *item, const char **key, uint32_t *key_len)
+{
+	node_feature_t *feature_ptr = (node_feature_t *) item;
+
+	*key = feature_ptr->name;
+	*key_len = strlen(feature_ptr->name);
+}
+
+/*
+ * (Re)build the name index of active_feature_list or avail_feature_list and
+ * advance feature_list_gen. Must be called with the node write lock held
+ * whenever a feature list is created or modified.
+ */
+static void _feature_hash_build(List feature_list)
+{
+	xhash_t **hash_pptr;
+	node_feature_t *feature_ptr;
+	ListIterator feature_iter;
+
+	if (++feature_list_gen == 0)
+		feature_list_gen = 1;
+
+	if (feature_list == active_feature_list)
+		hash_pptr = &active_feature_hash;
+	else if (feature_list == avail_feature_list)
+		hash_pptr = &avail_feature_hash;
+	else
+		return;
+	xassert(feature_list);
+
+	xhash_free(*hash_pptr);
+	*hash_pptr = xhash_init(_feature_hash_id, NULL);
+	feature_iter = list_iterator_create(feature_list);
+	while ((feature_ptr = (node_feature_t *) list_next(feature_iter)))
+		xhash_add(*hash_pptr, feature_ptr);
+	list_iterator_destroy(feature_iter);
+}
+
+/*
+ * Find the named record in active_feature_list or avail_feature_list
+ * feature_list IN - List to search: active_feature_list or avail_feature_list
+ * name IN - name of the feature
+ * RET pointer to the feature record or NULL if not found
+ */
+extern node_feature_t *find_feature_record(List feature_list, char *name)
+{
+	xhash_t *hash_ptr = NULL;
+
+	if (!feature_list || !name)
+		return NULL;
+	if (feature_list == active_feature_list)
+		hash_ptr = active_feature_hash;
+	else if (feature_list == avail_feature_list)
+		hash_ptr = avail_feature_hash;
+	if (!hash_ptr)
+		return list_find_first(feature_list, list_find_feature, name);
+
+	return xhash_get_str(hash_ptr, name);
+}
+
+/* Free the active and available feature lists and their name indexes */
+extern void free_feature_lists(void)
+{
+	xhash_free(active_feature_hash);
+	xhash_free(avail_feature_hash);
+	FREE_NULL_LIST(active_feature_list);
+	FREE_NULL_LIST(avail_feature_list);
+	if (++feature_list_gen == 0)
+		feature_list_gen = 1;
+}
+
 /* _list_delete_feature - delete an entry from the feature list,
  *	see list.h for documentation */
 static void _list_delete_feature(void *feature_entry)
@@ -1605,6 +1681,9 @@ extern void build_feature_list_eq(void)
 		list_append(active_feature_list, active_feature_ptr);
 	}
 	list_iterator_destroy(feature_iter);
+
+	_feature_hash_build(active_feature_list);
+	_feature_hash_build(avail_feature_list);
 }
 
 /*
@@ -1676,6 +1755,9 @@ extern void build_feature_list_ne(void)
 			xfree(tmp_str);
 		}
 	}
+
+	_feature_hash_build(active_feature_list);
+	_feature_hash_build(avail_feature_list);
 }
 
 /*
@@ -1710,6 +1792,7 @@ extern void update_feature_list(List feature_list, char *new_features,
 		}
 		xfree(tmp_str);
 	}
+	_feature_hash_build(feature_list);
 	node_features_updated = true;
 }
 
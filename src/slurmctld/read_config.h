@@ -80,6 +80,16 @@ extern void build_feature_list_eq(void);
  * build new active and available feature lists */
 extern void build_feature_list_ne(void);
 
+/* Find the named record in active_feature_list or avail_feature_list
+ * using the feature name index maintained with those lists
+ * feature_list IN - List to search: active_feature_list or avail_feature_list
+ * name IN - name of the feature
+ * RET pointer to the feature record or NULL if not found */
+extern node_feature_t *find_feature_record(List feature_list, char *name);
+
+/* Free the active and available feature lists and their name indexes */
+extern void free_feature_lists(void);
+
 /* Update active_feature_list or avail_feature_list
  * feature_list IN - List to update: active_feature_list or avail_feature_list
  * new_features IN - New active_features
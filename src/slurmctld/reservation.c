@@ -99,6 +99,36 @@ time_t    last_resv_update = (time_t) 0;
 List      resv_list = (List) NULL;
 uint32_t  top_suffix = 0;
 
+/*
+ * Index of resv_list used by job_test_resv() to find the reservations which
+ * might overlap a job's time window without testing every reservation.
+ * Entries are ordered by start time and record the latest end time of any
+ * entry at or before them, so a search can stop at the first entry whose
+ * max_end_time precedes the job's start. Reservations with a floating start
+ * time are kept separately and always tested, as are reservations which have
+ * ended (they are moved out of the sorted entries once their end time passes
+ * so that the caller can advance or skip them). Any change to resv_list or to
+ * a reservation's times clears resv_index_valid and the index is rebuilt on
+ * next use.
+ */
+typedef struct resv_index {
+	slurmctld_resv_t *resv_ptr;
+	int list_inx;		/* Position in resv_list */
+	time_t start_time;	/* Reservation's start_time_first */
+	time_t end_time;	/* Reservation's end_time */
+	time_t max_end_time;	/* Latest end_time of this and prior entries */
+} resv_index_t;
+
+static bool resv_index_valid = false;
+static resv_index_t *resv_index = NULL;		/* Fixed start times */
+static int resv_index_cnt = 0;
+static resv_index_t *resv_index_float = NULL;	/* Floating start times */
+static int resv_index_float_cnt = 0;
+static resv_index_t *resv_index_ended = NULL;	/* Ended fixed start times */
+static int resv_index_ended_cnt = 0;
+static time_t resv_index_min_end = (time_t) 0;	/* Earliest end_time */
+static uint32_t resv_index_max_boot = 0;	/* Largest boot_time */
+
 /*
  * the two following structs enable to build a
  * planning of a constraint evolution over time
@@ -196,6 +226,7 @@ static void _validate_node_choice(slurmctld_resv_t *resv_ptr);
 
 static void _set_boot_time(slurmctld_resv_t *resv_ptr)
 {
+	resv_index_valid = false;
 	resv_ptr->boot_time = 0;
 	if (!resv_ptr->node_bitmap)
 		return;
@@ -2366,6 +2397,7 @@ extern int create_resv(resv_desc_msg_t *resv_desc_ptr)
 
 	list_append(resv_list, resv_ptr);
 	last_resv_update = now;
+	resv_index_valid = false;
 	schedule_resv_save();
 
 	return SLURM_SUCCESS;
@@ -2385,6 +2417,11 @@ extern int create_resv(resv_desc_msg_t *resv_desc_ptr)
 extern void resv_fini(void)
 {
 	FREE_NULL_LIST(resv_list);
+	xfree(resv_index);
+	xfree(resv_index_float);
+	xfree(resv_index_ended);
+	resv_index_cnt = resv_index_float_cnt = resv_index_ended_cnt = 0;
+	resv_index_valid = false;
 }
 
 /* Update an exiting resource reservation */
@@ -2761,6 +2798,7 @@ extern int update_resv(resv_desc_msg_t *resv_desc_ptr)
 	_del_resv_rec(resv_backup);
 	(void) set_node_maint_mode(true);
 	last_resv_update = now;
+	resv_index_valid = false;
 	schedule_resv_save();
 	return error_code;
 
@@ -2896,6 +2934,7 @@ extern int delete_resv(reservation_name_msg_t *resv_desc_ptr)
 
 	(void) set_node_maint_mode(true);
 	last_resv_update = time(NULL);
+	resv_index_valid = false;
 	schedule_resv_save();
 	return rc;
 }
@@ -3194,6 +3233,7 @@ static bool _validate_one_reservation(slurmctld_resv_t *resv_ptr)
 		_set_tres_cnt(resv_ptr, &old_resv_ptr);
 		xfree(old_resv_ptr.tres_str);
 		last_resv_update = time(NULL);
+		resv_index_valid = false;
 	} else if (resv_ptr->flags & RESERVE_FLAG_ALL_NODES) {
 		memset(&old_resv_ptr, 0, sizeof(slurmctld_resv_t));
 		FREE_NULL_BITMAP(resv_ptr->node_bitmap);
@@ -3207,6 +3247,7 @@ static bool _validate_one_reservation(slurmctld_resv_t *resv_ptr)
 		_set_tres_cnt(resv_ptr, &old_resv_ptr);
 		xfree(old_resv_ptr.tres_str);
 		last_resv_update = time(NULL);
+		resv_index_valid = false;
 	} else if (resv_ptr->node_list) {	/* Change bitmap last */
 		/*
 		 * Node bitmap must be recreated in any case, i.e. when
@@ -3236,6 +3277,7 @@ static bool _validate_one_reservation(slurmctld_resv_t *resv_ptr)
 			_set_tres_cnt(resv_ptr, &old_resv_ptr);
 			xfree(old_resv_ptr.tres_str);
 			last_resv_update = time(NULL);
+			resv_index_valid = false;
 		}
 	}
 
@@ -3260,6 +3302,7 @@ static void _validate_all_reservations(void)
 			_post_resv_delete(resv_ptr);
 			_clear_job_resv(resv_ptr);
 			list_delete_item(iter);
+			resv_index_valid = false;
 		} else {
 			_set_assoc_list(resv_ptr);
 			top_suffix = MAX(top_suffix, resv_ptr->resv_id);
@@ -3367,6 +3410,7 @@ static void _resv_node_replace(slurmctld_resv_t *resv_ptr)
 	}
 	FREE_NULL_BITMAP(preserve_bitmap);
 	last_resv_update = time(NULL);
+	resv_index_valid = false;
 	schedule_resv_save();
 }
 
@@ -3479,6 +3523,7 @@ extern int load_all_resv_state(int recover)
 	uint16_t protocol_version = NO_VAL16;
 
 	last_resv_update = time(NULL);
+	resv_index_valid = false;
 	if ((recover == 0) && resv_list) {
 		_validate_all_reservations();
 		return SLURM_SUCCESS;
@@ -4914,6 +4959,154 @@ extern uint32_t job_test_watts_resv(struct job_record *job_ptr, time_t when,
 	return resv_cnt;
 }
 
+static int _resv_index_sort_start(const void *x, const void *y)
+{
+	const resv_index_t *r1 = (const resv_index_t *) x;
+	const resv_index_t *r2 = (const resv_index_t *) y;
+
+	if (r1->start_time < r2->start_time)
+		return -1;
+	if (r1->start_time > r2->start_time)
+		return 1;
+	return (r1->list_inx - r2->list_inx);
+}
+
+static int _resv_index_sort_inx(const void *x, const void *y)
+{
+	const resv_index_t *r1 = *(const resv_index_t **) x;
+	const resv_index_t *r2 = *(const resv_index_t **) y;
+
+	return (r1->list_inx - r2->list_inx);
+}
+
+/*
+ * Move the entries of resv_index which have ended by "now" to
+ * resv_index_ended, keeping the remaining entries in start time order, and
+ * recompute max_end_time and resv_index_min_end for them.
+ */
+static void _resv_index_expire(time_t now)
+{
+	int i, j;
+	time_t max_end_time = (time_t) 0;
+
+	resv_index_min_end = (time_t) 0;
+	for (i = 0, j = 0; i < resv_index_cnt; i++) {
+		if (resv_index[i].end_time <= now) {
+			resv_index_ended[resv_index_ended_cnt++] =
+				resv_index[i];
+			continue;
+		}
+		if (i != j)
+			resv_index[j] = resv_index[i];
+		max_end_time = MAX(max_end_time, resv_index[j].end_time);
+		resv_index[j].max_end_time = max_end_time;
+		if ((j == 0) || (resv_index[j].end_time < resv_index_min_end))
+			resv_index_min_end = resv_index[j].end_time;
+		j++;
+	}
+	resv_index_cnt = j;
+}
+
+/* Rebuild resv_index from the current contents of resv_list */
+static void _resv_index_build(time_t now)
+{
+	ListIterator iter;
+	slurmctld_resv_t *resv_ptr;
+	resv_index_t *index_ptr;
+	int list_cnt, list_inx = 0;
+
+	list_cnt = list_count(resv_list);
+	xfree(resv_index);
+	xfree(resv_index_float);
+	xfree(resv_index_ended);
+	resv_index = xmalloc(sizeof(resv_index_t) * (list_cnt + 1));
+	resv_index_float = xmalloc(sizeof(resv_index_t) * (list_cnt + 1));
+	resv_index_ended = xmalloc(sizeof(resv_index_t) * (list_cnt + 1));
+	resv_index_cnt = resv_index_float_cnt = resv_index_ended_cnt = 0;
+	resv_index_max_boot = 0;
+
+	iter = list_iterator_create(resv_list);
+	while ((resv_ptr = (slurmctld_resv_t *) list_next(iter))) {
+		if (resv_ptr->flags & RESERVE_FLAG_TIME_FLOAT) {
+			index_ptr = &resv_index_float[resv_index_float_cnt++];
+		} else {
+			index_ptr = &resv_index[resv_index_cnt++];
+			resv_index_max_boot = MAX(resv_index_max_boot,
+						  resv_ptr->boot_time);
+		}
+		index_ptr->resv_ptr = resv_ptr;
+		index_ptr->list_inx = list_inx++;
+		index_ptr->start_time = resv_ptr->start_time_first;
+		index_ptr->end_time = resv_ptr->end_time;
+	}
+	list_iterator_destroy(iter);
+
+	qsort(resv_index, resv_index_cnt, sizeof(resv_index_t),
+	      _resv_index_sort_start);
+	_resv_index_expire(now);
+	resv_index_valid = true;
+}
+
+/*
+ * Find the reservations which might overlap the time window from start_time
+ * to end_time, plus any which have ended and may need to be advanced.
+ * IN start_time - start of the job's time window
+ * IN end_time - end of the job's time window, excluding reservation boot_time
+ * IN reboot - true if node reboot required to start job
+ * IN now - current time
+ * OUT resv_array - reservations in resv_list order, caller must xfree
+ * RET count of reservations in resv_array
+ */
+static int _resv_index_find(time_t start_time, time_t end_time, bool reboot,
+			    time_t now, slurmctld_resv_t ***resv_array)
+{
+	resv_index_t **match;
+	slurmctld_resv_t **resv_ptrs;
+	int i, lo, hi, mid, match_cnt = 0;
+
+	if (!resv_index_valid)
+		_resv_index_build(now);
+	else if (resv_index_cnt && (resv_index_min_end <= now))
+		_resv_index_expire(now);
+	if (reboot)
+		end_time += resv_index_max_boot;
+
+	match = xmalloc(sizeof(resv_index_t *) *
+			(resv_index_cnt + resv_index_float_cnt +
+			 resv_index_ended_cnt + 1));
+	for (i = 0; i < resv_index_float_cnt; i++)
+		match[match_cnt++] = &resv_index_float[i];
+	/* Ended reservations are tested so they can be advanced */
+	for (i = 0; i < resv_index_ended_cnt; i++)
+		match[match_cnt++] = &resv_index_ended[i];
+
+	/* Find the first entry starting at or after end_time */
+	lo = 0;
+	hi = resv_index_cnt;
+	while (lo < hi) {
+		mid = (lo + hi) / 2;
+		if (resv_index[mid].start_time < end_time)
+			lo = mid + 1;
+		else
+			hi = mid;
+	}
+	for (i = lo - 1; i >= 0; i--) {
+		if (resv_index[i].max_end_time <= start_time)
+			break;
+		if (resv_index[i].end_time > start_time)
+			match[match_cnt++] = &resv_index[i];
+	}
+
+	qsort(match, match_cnt, sizeof(resv_index_t *), _resv_index_sort_inx);
+	resv_ptrs = xmalloc(sizeof(slurmctld_resv_t *) * (match_cnt + 1));
+	for (i = 0; i < match_cnt; i++)
+		resv_ptrs[i] = match[i]->resv_ptr;
+	xfree(match);
+
+	*resv_array = resv_ptrs;
+	return match_cnt;
+}
+
 /*
  * Determine which nodes a job can use based upon reservations
  * IN job_ptr      - job to test
@@ -4947,7 +5140,8 @@ extern int job_test_resv(struct job_record *job_ptr, time_t *when,
 	time_t start_relative, end_relative;
 	time_t now = time(NULL);
 	ListIterator iter;
-	int i, rc = SLURM_SUCCESS, rc2;
+	slurmctld_resv_t **resv_array;
+	int i, j, resv_cnt, rc = SLURM_SUCCESS, rc2;
 
 	*resv_overlap = false;	/* initialize to false */
 	job_start_time = *when;
@@ -5079,8 +5273,10 @@ extern int job_test_resv(struct job_record *job_ptr, time_t *when,
 	for (i = 0; ; i++) {
 		lic_resv_time = (time_t) 0;
 
-		iter = list_iterator_create(resv_list);
-		while ((resv_ptr = (slurmctld_resv_t *) list_next(iter))) {
+		resv_cnt = _resv_index_find(job_start_time, job_end_time,
+					    reboot, now, &resv_array);
+		for (j = 0; j < resv_cnt; j++) {
+			resv_ptr = resv_array[j];
 			if (resv_ptr->flags & RESERVE_FLAG_TIME_FLOAT) {
 				start_relative = resv_ptr->start_time + now;
 				if (resv_ptr->duration == INFINITE)
@@ -5177,7 +5373,7 @@ extern int job_test_resv(struct job_record *job_ptr, time_t *when,
 				continue;
 			}
 		}
-		list_iterator_destroy(iter);
+		xfree(resv_array);
 
 		if ((rc == SLURM_SUCCESS) && move_time) {
 			if (license_job_test(job_ptr, job_start_time, reboot)
@@ -5370,6 +5566,7 @@ static void _advance_resv_time(slurmctld_resv_t *resv_ptr)
 		_advance_time(&resv_ptr->end_time, day_cnt);
 		_post_resv_create(resv_ptr);
 		last_resv_update = time(NULL);
+		resv_index_valid = false;
 		schedule_resv_save();
 	}
 }
@@ -5500,6 +5697,7 @@ extern void job_resv_check(void)
 			_post_resv_update(resv_ptr, resv_backup); /* accounting */
 			_del_resv_rec(resv_backup);
 			last_resv_update = now;
+			resv_index_valid = false;
 			schedule_resv_save();
 		}
 		if (!resv_ptr->run_prolog || !resv_ptr->run_epilog)
@@ -5528,6 +5726,7 @@ extern void job_resv_check(void)
 			_clear_job_resv(resv_ptr);
 			list_delete_item(iter);
 			last_resv_update = now;
+			resv_index_valid = false;
 			schedule_resv_save();
 		}
 	}
@@ -5725,6 +5924,7 @@ extern void update_part_nodes_in_resv(struct part_record *part_ptr)
 			_set_tres_cnt(resv_ptr, &old_resv_ptr);
 			xfree(old_resv_ptr.tres_str);
 			last_resv_update = time(NULL);
+			resv_index_valid = false;
 			_set_boot_time(resv_ptr);
 		}
 	}
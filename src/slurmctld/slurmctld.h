@@ -251,6 +251,7 @@ typedef struct node_features {
 
 extern List active_feature_list;/* list of currently active node features */
 extern List avail_feature_list;	/* list of available node features */
+extern uint32_t feature_list_gen;/* changes with feature list contents */
 
 /*****************************************************************************\
  *  NODE states and bitmaps
@@ -484,6 +485,9 @@ typedef struct job_feature {
 	bitstr_t *node_bitmap_active;	/* nodes with this feature active */
 	bitstr_t *node_bitmap_avail;	/* nodes with this feature available */
 	uint16_t paren;			/* count of enclosing parenthesis */
+	uint32_t feature_gen;		/* feature_list_gen of node_bitmap_*,
+					 * zero if not yet set */
+	bool feature_reboot;		/* can_reboot of node_bitmap_avail */
 } job_feature_t;
 
 /*
@@ -806,6 +810,12 @@ struct job_record {
 					 * this job, confirm the
 					 * value before use */
 	void *qos_blocking_ptr;		/* internal use only, DON'T PACK */
+	uint32_t qos_valid_assoc_id;	/* assoc_id when QOS last found valid,
+					 * internal use only, DON'T PACK */
+	uint32_t qos_valid_gen;		/* assoc_mgr_get_conf_gen() when QOS
+					 * last found valid, DON'T PACK */
+	uint32_t qos_valid_qos_id;	/* qos_id when QOS last found valid,
+					 * internal use only, DON'T PACK */
 	uint8_t reboot;			/* node reboot requested before start */
 	uint16_t restart_cnt;		/* count of restarts */
 	time_t resize_time;		/* time of latest size change */
@@ -91,6 +91,15 @@ static bool trigger_pri_dbd_res_op = false;
 static bool trigger_pri_db_fail = false;
 static bool trigger_pri_db_res_op = false;
 
+/*
+ * TRIGGER_TYPE_* flags of pending triggers. When an event of one of these
+ * types occurs, trigger_event_flag is set so that trigger_process() runs on
+ * the next pass of the background thread rather than waiting for the next
+ * TRIGGER_INTERVAL.
+ */
+static uint32_t trigger_sub_types = 0;
+static bool trigger_event_flag = false;
+
 /* Current trigger pull states (saved and restored) */
 uint8_t ctld_failure = 0;
 uint8_t bu_ctld_failure = 0;
@@ -493,6 +502,7 @@ extern int trigger_set(uid_t uid, gid_t gid, trigger_info_msg_t *msg)
 			continue;
 		}
 		list_append(trigger_list, trig_add);
+		trigger_sub_types |= trig_add->trig_type;
 		schedule_trigger_save();
 	}
 
@@ -501,6 +511,35 @@ fini:	slurm_mutex_unlock(&trigger_mutex);
 	return rc;
 }
 
+/*
+ * Note that an event of the given TRIGGER_TYPE_* has occurred
+ * trigger_mutex should be locked before calling this.
+ */
+static void _trigger_event(uint32_t trig_type)
+{
+	if (trigger_sub_types & trig_type)
+		trigger_event_flag = true;
+}
+
+/* Return true if an event has occurred for which a trigger is pending */
+extern bool trigger_event_pending(void)
+{
+	bool rc;
+
+	slurm_mutex_lock(&trigger_mutex);
+	rc = trigger_event_flag;
+	slurm_mutex_unlock(&trigger_mutex);
+
+	return rc;
+}
+
+extern void trigger_job_fini(void)
+{
+	slurm_mutex_lock(&trigger_mutex);
+	_trigger_event(TRIGGER_TYPE_FINI);
+	slurm_mutex_unlock(&trigger_mutex);
+}
+
 extern void trigger_front_end_down(front_end_record_t *front_end_ptr)
 {
 	int inx = front_end_ptr - front_end_nodes;
@@ -511,6 +550,7 @@ extern void trigger_front_end_down(front_end_record_t *front_end_ptr)
 	if (trigger_down_front_end_bitmap == NULL)
 		trigger_down_front_end_bitmap = bit_alloc(front_end_node_cnt);
 	bit_set(trigger_down_front_end_bitmap, inx);
+	_trigger_event(TRIGGER_TYPE_DOWN);
 	slurm_mutex_unlock(&trigger_mutex);
 }
 
@@ -524,6 +564,7 @@ extern void trigger_front_end_up(front_end_record_t *front_end_ptr)
 	if (trigger_up_front_end_bitmap == NULL)
 		trigger_up_front_end_bitmap = bit_alloc(front_end_node_cnt);
 	bit_set(trigger_up_front_end_bitmap, inx);
+	_trigger_event(TRIGGER_TYPE_UP);
 	slurm_mutex_unlock(&trigger_mutex);
 }
 
@@ -537,6 +578,7 @@ extern void trigger_node_down(struct node_record *node_ptr)
 	if (trigger_down_nodes_bitmap == NULL)
 		trigger_down_nodes_bitmap = bit_alloc(node_record_count);
 	bit_set(trigger_down_nodes_bitmap, inx);
+	_trigger_event(TRIGGER_TYPE_DOWN);
 	slurm_mutex_unlock(&trigger_mutex);
 }
 
@@ -550,6 +592,7 @@ extern void trigger_node_drained(struct node_record *node_ptr)
 	if (trigger_drained_nodes_bitmap == NULL)
 		trigger_drained_nodes_bitmap = bit_alloc(node_record_count);
 	bit_set(trigger_drained_nodes_bitmap, inx);
+	_trigger_event(TRIGGER_TYPE_DRAINED);
 	slurm_mutex_unlock(&trigger_mutex);
 }
 
@@ -563,6 +606,7 @@ extern void trigger_node_failing(struct node_record *node_ptr)
 	if (trigger_fail_nodes_bitmap == NULL)
 		trigger_fail_nodes_bitmap = bit_alloc(node_record_count);
 	bit_set(trigger_fail_nodes_bitmap, inx);
+	_trigger_event(TRIGGER_TYPE_FAIL);
 	slurm_mutex_unlock(&trigger_mutex);
 }
 
@@ -577,6 +621,7 @@ extern void trigger_node_up(struct node_record *node_ptr)
 	if (trigger_up_nodes_bitmap == NULL)
 		trigger_up_nodes_bitmap = bit_alloc(node_record_count);
 	bit_set(trigger_up_nodes_bitmap, inx);
+	_trigger_event(TRIGGER_TYPE_UP);
 	slurm_mutex_unlock(&trigger_mutex);
 }
 
@@ -587,6 +632,7 @@ extern void trigger_reconfig(void)
 	lock_slurmctld(node_read_lock);
 	slurm_mutex_lock(&trigger_mutex);
 	trigger_node_reconfig = true;
+	_trigger_event(TRIGGER_TYPE_RECONFIG);
 	if (trigger_down_front_end_bitmap)
 		trigger_down_front_end_bitmap = bit_realloc(
 			trigger_down_front_end_bitmap, node_record_count);
@@ -614,6 +660,7 @@ extern void trigger_primary_ctld_fail(void)
 	slurm_mutex_lock(&trigger_mutex);
 	if (ctld_failure != 1) {
 		trigger_pri_ctld_fail = true;
+		_trigger_event(TRIGGER_TYPE_PRI_CTLD_FAIL);
 		ctld_failure = 1;
 	}
 	slurm_mutex_unlock(&trigger_mutex);
@@ -623,6 +670,7 @@ extern void trigger_primary_ctld_res_op(void)
 {
 	slurm_mutex_lock(&trigger_mutex);
 	trigger_pri_ctld_res_op = true;
+	_trigger_event(TRIGGER_TYPE_PRI_CTLD_RES_OP);
 	ctld_failure = 0;
 	slurm_mutex_unlock(&trigger_mutex);
 }
@@ -631,6 +679,7 @@ extern void trigger_primary_ctld_res_ctrl(void)
 {
 	slurm_mutex_lock(&trigger_mutex);
 	trigger_pri_ctld_res_ctrl = true;
+	_trigger_event(TRIGGER_TYPE_PRI_CTLD_RES_CTRL);
 	slurm_mutex_unlock(&trigger_mutex);
 }
 
@@ -638,6 +687,7 @@ extern void trigger_primary_ctld_acct_full(void)
 {
 	slurm_mutex_lock(&trigger_mutex);
 	trigger_pri_ctld_acct_buffer_full = true;
+	_trigger_event(TRIGGER_TYPE_PRI_CTLD_ACCT_FULL);
 	slurm_mutex_unlock(&trigger_mutex);
 }
 
@@ -646,6 +696,7 @@ extern void trigger_backup_ctld_fail(int index)
 	slurm_mutex_lock(&trigger_mutex);
 	if (bu_ctld_failure != 1) {
 		trigger_bu_ctld_fail = true;
+		_trigger_event(TRIGGER_TYPE_BU_CTLD_FAIL);
 		bu_ctld_failure = 1;
 	}
 	slurm_mutex_unlock(&trigger_mutex);
@@ -655,6 +706,7 @@ extern void trigger_backup_ctld_res_op(int index)
 {
 	slurm_mutex_lock(&trigger_mutex);
 	trigger_bu_ctld_res_op = true;
+	_trigger_event(TRIGGER_TYPE_BU_CTLD_RES_OP);
 	bu_ctld_failure = 0;
 	slurm_mutex_unlock(&trigger_mutex);
 }
@@ -663,6 +715,7 @@ extern void trigger_backup_ctld_as_ctrl(void)
 {
 	slurm_mutex_lock(&trigger_mutex);
 	trigger_bu_ctld_as_ctrl = true;
+	_trigger_event(TRIGGER_TYPE_BU_CTLD_AS_CTRL);
 	slurm_mutex_unlock(&trigger_mutex);
 }
 
@@ -671,6 +724,7 @@ extern void trigger_primary_dbd_fail(void)
 	slurm_mutex_lock(&trigger_mutex);
 	if (dbd_failure != 1) {
 		trigger_pri_dbd_fail = true;
+		_trigger_event(TRIGGER_TYPE_PRI_DBD_FAIL);
 		dbd_failure = 1;
 	}
 	slurm_mutex_unlock(&trigger_mutex);
@@ -680,6 +734,7 @@ extern void trigger_primary_dbd_res_op(void)
 {
 	slurm_mutex_lock(&trigger_mutex);
 	trigger_pri_dbd_res_op = true;
+	_trigger_event(TRIGGER_TYPE_PRI_DBD_RES_OP);
 	dbd_failure = 0;
 	slurm_mutex_unlock(&trigger_mutex);
 }
@@ -689,6 +744,7 @@ extern void trigger_primary_db_fail(void)
 	slurm_mutex_lock(&trigger_mutex);
 	if (db_failure != 1) {
 		trigger_pri_db_fail = true;
+		_trigger_event(TRIGGER_TYPE_PRI_DB_FAIL);
 		db_failure = 1;
 	}
 	slurm_mutex_unlock(&trigger_mutex);
@@ -698,6 +754,7 @@ extern void trigger_primary_db_res_op(void)
 {
 	slurm_mutex_lock(&trigger_mutex);
 		trigger_pri_db_res_op = true;
+		_trigger_event(TRIGGER_TYPE_PRI_DB_RES_OP);
 		db_failure = 0;
 	slurm_mutex_unlock(&trigger_mutex);
 }
@@ -706,6 +763,7 @@ extern void trigger_burst_buffer(void)
 {
 	slurm_mutex_lock(&trigger_mutex);
 	trigger_bb_error = true;
+	_trigger_event(TRIGGER_TYPE_BURST_BUFFER);
 	slurm_mutex_unlock(&trigger_mutex);
 }
 
@@ -798,6 +856,7 @@ static int _load_trigger_state(Buf buffer, uint16_t protocol_version)
 	if (trigger_list == NULL)
 		trigger_list = list_create(_trig_del);
 	list_append(trigger_list, trig_ptr);
+	trigger_sub_types |= trig_ptr->trig_type;
 	next_trigger_id = MAX(next_trigger_id, trig_ptr->trig_id + 1);
 	slurm_mutex_unlock(&trigger_mutex);
 
@@ -1631,6 +1690,7 @@ extern void trigger_process(void)
 	if (trigger_list == NULL)
 		trigger_list = list_create(_trig_del);
 
+	trigger_sub_types = 0;
 	trig_iter = list_iterator_create(trigger_list);
 	while ((trig_in = list_next(trig_iter))) {
 		if (trig_in->state == 0) {
@@ -1652,6 +1712,8 @@ extern void trigger_process(void)
 			else if (trig_in->res_type ==
 				 TRIGGER_RES_TYPE_FRONT_END)
 			 	_trigger_front_end_event(trig_in, now);
+			if (trig_in->state == 0)
+				trigger_sub_types |= trig_in->trig_type;
 		}
 		if ((trig_in->state == 1) &&
 		    (trig_in->trig_time <= now)) {
@@ -1664,6 +1726,7 @@ extern void trigger_process(void)
 			}
 			if (trig_in->flags & TRIGGER_FLAG_PERM) {
 				_trigger_clone(trig_in);
+				trigger_sub_types |= trig_in->trig_type;
 			}
 			trig_in->state = 2;
 			trig_in->trig_time = now;
@@ -1718,6 +1781,7 @@ extern void trigger_process(void)
 	}
 	list_iterator_destroy(trig_iter);
 	_clear_event_triggers();
+	trigger_event_flag = false;
 	slurm_mutex_unlock(&trigger_mutex);
 	if (state_change)
 		schedule_trigger_save();
@@ -1733,4 +1797,6 @@ extern void trigger_fini(void)
 	FREE_NULL_BITMAP(trigger_drained_nodes_bitmap);
 	FREE_NULL_BITMAP(trigger_fail_nodes_bitmap);
 	FREE_NULL_BITMAP(trigger_up_nodes_bitmap);
+	trigger_sub_types = 0;
+	trigger_event_flag = false;
 }
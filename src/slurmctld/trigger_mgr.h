@@ -58,6 +58,7 @@ extern void trigger_block_error(void);
 extern void trigger_burst_buffer(void);
 extern void trigger_front_end_down(front_end_record_t *front_end_ptr);
 extern void trigger_front_end_up(front_end_record_t *front_end_ptr);
+extern void trigger_job_fini(void);
 extern void trigger_node_down(struct node_record *node_ptr);
 extern void trigger_node_drained(struct node_record *node_ptr);
 extern void trigger_node_failing(struct node_record *node_ptr);
@@ -82,6 +83,9 @@ extern void trigger_state_restore(void);
 /* Free all allocated memory */
 extern void trigger_fini(void);
 
+/* Return true if an event has occurred for which a trigger is pending */
+extern bool trigger_event_pending(void);
+
 /* Execute programs as needed for triggers that have been pulled
  * and purge any vestigial trigger records */
 extern void trigger_process(void);
@@ -63,6 +63,7 @@ int _file_read_uint64s(char* file_path, uint64_t** pvalues, int* pnb);
 int _file_write_uint64s(char* file_path, uint64_t* values, int nb);
 int _file_read_content(char* file_path, char** content, size_t *csize);
 int _file_write_content(char* file_path, char* content, size_t csize);
+int _file_write_lines(char* cpath, char** param, char** content, int nb);
 
 
 /*
@@ -428,6 +429,7 @@ int xcgroup_instantiate(xcgroup_t* cg)
 	char* file_path;
 	uid_t uid;
 	gid_t gid;
+	struct stat st;
 
 	/* init variables based on input cgroup */
 	file_path = cg->path;
@@ -449,8 +451,18 @@ int xcgroup_instantiate(xcgroup_t* cg)
 			debug("%s: cgroup '%s' already exists",
 			      __func__, file_path);
 		}
-	}
-	umask(omask);
+		umask(omask);
+
+		/*
+		 * An existing cgroup with the requested ownership was set up
+		 * by an earlier instantiation, typically the uid and job
+		 * cgroups shared by the steps of a job.
+		 */
+		if ((stat(file_path, &st) == 0) &&
+		    (st.st_uid == uid) && (st.st_gid == gid))
+			return XCGROUP_SUCCESS;
+	} else
+		umask(omask);
 
 	/* change cgroup ownership as requested */
 	if (chown(file_path, uid, gid)) {
@@ -599,6 +611,25 @@ int xcgroup_set_param(xcgroup_t* cg, char* param, char* content)
 	return fstatus;
 }
 
+int xcgroup_set_param_lines(xcgroup_t* cg, char** param, char** content,
+			    int nb)
+{
+	int fstatus;
+
+	if (!nb)
+		return XCGROUP_SUCCESS;
+
+	fstatus = _file_write_lines(cg->path, param, content, nb);
+	if (fstatus != XCGROUP_SUCCESS)
+		debug2("%s: unable to set parameters for '%s'",
+			__func__, cg->path);
+	else
+		debug3("%s: parameters set to %d values for '%s'",
+			__func__, nb, cg->path);
+
+	return fstatus;
+}
+
 int xcgroup_wait_pid_moved(xcgroup_t* cg, const char *cg_name)
 {
 	pid_t *pids = NULL;
@@ -1109,6 +1140,81 @@ int _file_write_content(char* file_path, char* content, size_t csize)
 	return fstatus;
 }
 
+int _file_write_lines(char* cpath, char** param, char** content, int nb)
+{
+	int fstatus = XCGROUP_SUCCESS;
+	int rc;
+	int *fd;
+	bool *shared;
+	size_t csize;
+	int i, j;
+	char file_path[PATH_MAX];
+
+	/* open each distinct file once, sharing its fd with later entries */
+	fd = xmalloc(sizeof(int) * nb);
+	shared = xmalloc(sizeof(bool) * nb);
+	for (i = 0; i < nb; i++) {
+		for (j = 0; j < i; j++) {
+			if (!xstrcmp(param[j], param[i]))
+				break;
+		}
+		if (j < i) {
+			fd[i] = fd[j];
+			shared[i] = true;
+			continue;
+		}
+
+		if (snprintf(file_path, PATH_MAX, "%s/%s", cpath, param[i])
+		    >= PATH_MAX) {
+			debug2("unable to build filepath for '%s' and"
+			       " parameter '%s' : %m", cpath, param[i]);
+			fd[i] = -1;
+			fstatus = XCGROUP_ERROR;
+			continue;
+		}
+
+		/* open file for writing */
+		fd[i] = open(file_path, O_WRONLY, 0700);
+		if (fd[i] < 0) {
+			debug2("%s: unable to open '%s' for writing : %m",
+				__func__, file_path);
+			fd[i] = -1;
+			fstatus = XCGROUP_ERROR;
+		}
+	}
+
+	/*
+	 * write each value separately and in the given order, as a cgroup
+	 * file takes one value per write and later values may override
+	 * earlier ones (e.g. devices.allow and devices.deny)
+	 */
+	for (i = 0; i < nb; i++) {
+		if (fd[i] < 0)
+			continue;
+
+		csize = strlen(content[i]);
+		do {
+			rc = write(fd[i], content[i], csize);
+		} while (rc < 0 && errno == EINTR);
+
+		if (rc < csize) {
+			debug2("%s: unable to write '%s' to file '%s/%s' : %m",
+				__func__, content[i], cpath, param[i]);
+			fstatus = XCGROUP_ERROR;
+		}
+	}
+
+	/* close files */
+	for (i = 0; i < nb; i++) {
+		if ((fd[i] >= 0) && !shared[i])
+			close(fd[i]);
+	}
+	xfree(fd);
+	xfree(shared);
+
+	return fstatus;
+}
+
 int _file_read_content(char* file_path, char** content, size_t *csize)
 {
 	int fstatus;
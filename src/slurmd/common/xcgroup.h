@@ -230,6 +230,23 @@ int xcgroup_get_pids(xcgroup_t* cg, pid_t **pids, int *npids);
  */
 int xcgroup_set_param(xcgroup_t* cg, char* parameter, char* content);
 
+/*
+ * set cgroup parameters to several values in turn
+ *
+ * param[i] must correspond to a file of the cgroup that
+ * will be written with content[i]. The nb values are written
+ * in order, each distinct file being opened only once
+ *
+ * i.e. xcgroup_set_param_lines(&cg,files,rules,nb);
+ *      with files[i] being "devices.allow" or "devices.deny"
+ *
+ * returned values:
+ *  - XCGROUP_ERROR
+ *  - XCGROUP_SUCCESS
+ */
+int xcgroup_set_param_lines(xcgroup_t* cg, char** param, char** content,
+			    int nb);
+
 /*
  * get a cgroup parameter
  *
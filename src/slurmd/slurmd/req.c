@@ -39,6 +39,8 @@
  *  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301  USA.
 \*****************************************************************************/
 
+#define _GNU_SOURCE	/* For pipe2() */
+
 #include "config.h"
 
 #include <ctype.h>
@@ -273,6 +275,19 @@ static uint32_t active_job_id[JOB_STATE_CNT] = {0};
 static pthread_mutex_t prolog_mutex = PTHREAD_MUTEX_INITIALIZER;
 static pthread_mutex_t prolog_serial_mutex = PTHREAD_MUTEX_INITIALIZER;
 
+/*
+ * With LaunchParameters=slurmstepd_prefork one spare slurmstepd is kept
+ * forked and exec'd. It blocks reading its initialization data, which the
+ * next step launch sends over the spare's pipes.
+ */
+static pthread_mutex_t stepd_spare_mutex = PTHREAD_MUTEX_INITIALIZER;
+static int stepd_spare_to_stepd = -1;	/* write end of spare's stdin */
+static int stepd_spare_to_slurmd = -1;	/* read end of spare's stdout */
+static bool stepd_spare_busy = false;	/* spare being created */
+static int stepd_spare_threads = 0;	/* _stepd_spare_create() threads */
+static pthread_cond_t stepd_spare_cond = PTHREAD_COND_INITIALIZER;
+static uint32_t stepd_spare_gen = 0;	/* incremented on purge */
+
 #define FILE_BCAST_TIMEOUT 300
 static pthread_mutex_t file_bcast_mutex = PTHREAD_MUTEX_INITIALIZER;
 static pthread_cond_t  file_bcast_cond  = PTHREAD_COND_INITIALIZER;
@@ -689,34 +704,20 @@ rwfail:
 
 
 /*
- * Fork and exec the slurmstepd, then send the slurmstepd its
- * initialization data.  Then wait for slurmstepd to send an "ok"
- * message before returning.  When the "ok" message is received,
- * the slurmstepd has created and begun listening on its unix
- * domain socket.
+ * Fork and exec a slurmstepd reading its initialization data from
+ * to_stepd[0] and writing its return code to to_slurmd[1]. The parent's
+ * copies of those ends are closed.
  *
  * Note that this code forks twice and it is the grandchild that
  * becomes the slurmstepd process, so the slurmstepd's parent process
  * will be init, not slurmd.
+ *
+ * RET pid of the child to be reaped by the caller or -1 on error
  */
-static int
-_forkexec_slurmstepd(uint16_t type, void *req,
-		     slurm_addr_t *cli, slurm_addr_t *self,
-		     const hostset_t step_hset, uint16_t protocol_version)
+static pid_t _spawn_slurmstepd(uint16_t type, void *req,
+			       int to_stepd[2], int to_slurmd[2])
 {
 	pid_t pid;
-	int to_stepd[2] = {-1, -1};
-	int to_slurmd[2] = {-1, -1};
-
-	if (pipe(to_stepd) < 0 || pipe(to_slurmd) < 0) {
-		error("_forkexec_slurmstepd pipe failed: %m");
-		return SLURM_ERROR;
-	}
-
-	if (_add_starting_step(type, req)) {
-		error("_forkexec_slurmstepd failed in _add_starting_step: %m");
-		return SLURM_ERROR;
-	}
 
 	if ((pid = fork()) < 0) {
 		error("_forkexec_slurmstepd: fork: %m");
@@ -724,14 +725,8 @@ _forkexec_slurmstepd(uint16_t type, void *req,
 		close(to_stepd[1]);
 		close(to_slurmd[0]);
 		close(to_slurmd[1]);
-		_remove_starting_step(type, req);
-		return SLURM_ERROR;
+		return -1;
 	} else if (pid > 0) {
-		int rc = SLURM_SUCCESS;
-#if (SLURMSTEPD_MEMCHECK == 0)
-		int i;
-		time_t start_time = time(NULL);
-#endif
 		/*
 		 * Parent sends initialization data to the slurmstepd
 		 * over the to_stepd pipe, and waits for the return code
@@ -741,58 +736,7 @@ _forkexec_slurmstepd(uint16_t type, void *req,
 			error("Unable to close read to_stepd in parent: %m");
 		if (close(to_slurmd[1]) < 0)
 			error("Unable to close write to_slurmd in parent: %m");
-
-		if ((rc = _send_slurmstepd_init(to_stepd[1], type,
-						req, cli, self,
-						step_hset,
-						protocol_version)) != 0) {
-			error("Unable to init slurmstepd");
-			goto done;
-		}
-
-		/* If running under valgrind/memcheck, this pipe doesn't work
-		 * correctly so just skip it. */
-#if (SLURMSTEPD_MEMCHECK == 0)
-		i = read(to_slurmd[0], &rc, sizeof(int));
-		if (i < 0) {
-			error("%s: Can not read return code from slurmstepd "
-			      "got %d: %m", __func__, i);
-			rc = SLURM_ERROR;
-		} else if (i != sizeof(int)) {
-			error("%s: slurmstepd failed to send return code "
-			      "got %d: %m", __func__, i);
-			rc = SLURM_ERROR;
-		} else {
-			int delta_time = time(NULL) - start_time;
-			int cc;
-			if (delta_time > 5) {
-				info("Warning: slurmstepd startup took %d sec, "
-				     "possible file system problem or full "
-				     "memory", delta_time);
-			}
-			if (rc != SLURM_SUCCESS)
-				error("slurmstepd return code %d", rc);
-
-			cc = SLURM_SUCCESS;
-			cc = write(to_stepd[1], &cc, sizeof(int));
-			if (cc != sizeof(int)) {
-				error("%s: failed to send ack to stepd %d: %m",
-				      __func__, cc);
-			}
-		}
-#endif
-	done:
-		if (_remove_starting_step(type, req))
-			error("Error cleaning up starting_step list");
-
-		/* Reap child */
-		if (waitpid(pid, NULL, 0) < 0)
-			error("Unable to reap slurmd child process");
-		if (close(to_stepd[1]) < 0)
-			error("close write to_stepd in parent: %m");
-		if (close(to_slurmd[0]) < 0)
-			error("close read to_slurmd in parent: %m");
-		return rc;
+		return pid;
 	} else {
 #if (SLURMSTEPD_MEMCHECK == 1)
 		/* memcheck test of slurmstepd, option #1 */
@@ -941,6 +885,238 @@ _forkexec_slurmstepd(uint16_t type, void *req,
 	}
 }
 
+/*
+ * Fork and exec a spare slurmstepd for the next step launch to use.
+ * The spare is discarded if stepd_spare_purge() runs while it is created.
+ */
+static void _stepd_spare_fork(void)
+{
+	int to_stepd[2] = {-1, -1};
+	int to_slurmd[2] = {-1, -1};
+	uint32_t gen;
+	pid_t pid;
+
+	slurm_mutex_lock(&stepd_spare_mutex);
+	if (stepd_spare_busy || (stepd_spare_to_stepd >= 0)) {
+		slurm_mutex_unlock(&stepd_spare_mutex);
+		return;
+	}
+	stepd_spare_busy = true;
+	gen = stepd_spare_gen;
+	slurm_mutex_unlock(&stepd_spare_mutex);
+
+	/*
+	 * The spare's pipes are kept open, so they must not leak into other
+	 * processes slurmd forks (e.g. a prolog) or the spare would never see
+	 * EOF when purged. The grandchild dup2()s its ends over stdin/stdout.
+	 */
+	if ((pipe2(to_stepd, O_CLOEXEC) < 0) ||
+	    (pipe2(to_slurmd, O_CLOEXEC) < 0)) {
+		error("%s: pipe failed: %m", __func__);
+		if (to_stepd[0] >= 0) {
+			close(to_stepd[0]);
+			close(to_stepd[1]);
+		}
+		pid = -1;
+	} else if ((pid = _spawn_slurmstepd(0, NULL, to_stepd,
+					     to_slurmd)) > 0) {
+		if (waitpid(pid, NULL, 0) < 0)
+			error("Unable to reap slurmd child process");
+	}
+
+	slurm_mutex_lock(&stepd_spare_mutex);
+	stepd_spare_busy = false;
+	if ((pid > 0) && (gen == stepd_spare_gen)) {
+		stepd_spare_to_stepd = to_stepd[1];
+		stepd_spare_to_slurmd = to_slurmd[0];
+		pid = 0;
+	}
+	slurm_mutex_unlock(&stepd_spare_mutex);
+
+	if (pid > 0) {
+		close(to_stepd[1]);
+		close(to_slurmd[0]);
+	}
+}
+
+/* Thread started by _stepd_spare_start(), counted in stepd_spare_threads */
+static void *_stepd_spare_create(void *arg)
+{
+	_stepd_spare_fork();
+
+	slurm_mutex_lock(&stepd_spare_mutex);
+	stepd_spare_threads--;
+	slurm_cond_broadcast(&stepd_spare_cond);
+	slurm_mutex_unlock(&stepd_spare_mutex);
+	return NULL;
+}
+
+/* Start a thread to create a spare slurmstepd */
+static void _stepd_spare_start(void)
+{
+	slurm_mutex_lock(&stepd_spare_mutex);
+	stepd_spare_threads++;
+	slurm_mutex_unlock(&stepd_spare_mutex);
+	slurm_thread_create_detached(NULL, _stepd_spare_create, NULL);
+}
+
+/*
+ * Take the spare slurmstepd if there is one still waiting for its
+ * initialization data. A spare that died would have closed its stdout.
+ * RET true if to_stepd[1] and to_slurmd[0] were set to the spare's pipes
+ */
+static bool _stepd_spare_get(int to_stepd[2], int to_slurmd[2])
+{
+	struct pollfd pfd;
+
+	slurm_mutex_lock(&stepd_spare_mutex);
+	to_stepd[1] = stepd_spare_to_stepd;
+	to_slurmd[0] = stepd_spare_to_slurmd;
+	stepd_spare_to_stepd = -1;
+	stepd_spare_to_slurmd = -1;
+	slurm_mutex_unlock(&stepd_spare_mutex);
+
+	if (to_stepd[1] < 0)
+		return false;
+
+	pfd.fd = to_slurmd[0];
+	pfd.events = POLLIN;
+	pfd.revents = 0;
+	if (poll(&pfd, 1, 0) != 0) {
+		debug("%s: spare slurmstepd is gone", __func__);
+		close(to_stepd[1]);
+		close(to_slurmd[0]);
+		to_stepd[1] = -1;
+		to_slurmd[0] = -1;
+		return false;
+	}
+	return true;
+}
+
+/*
+ * Discard the spare slurmstepd, which exits when its stdin is closed.
+ * Waits for any thread still creating a spare, so nothing of the spare
+ * outlives this call (e.g. at shutdown, before the configuration is freed).
+ */
+extern void stepd_spare_purge(void)
+{
+	slurm_mutex_lock(&stepd_spare_mutex);
+	while (stepd_spare_threads > 0)
+		slurm_cond_wait(&stepd_spare_cond, &stepd_spare_mutex);
+	stepd_spare_gen++;
+	if (stepd_spare_to_stepd >= 0) {
+		close(stepd_spare_to_stepd);
+		close(stepd_spare_to_slurmd);
+		stepd_spare_to_stepd = -1;
+		stepd_spare_to_slurmd = -1;
+	}
+	slurm_mutex_unlock(&stepd_spare_mutex);
+}
+
+/*
+ * Fork and exec the slurmstepd (or take the spare one), then send the
+ * slurmstepd its initialization data.  Then wait for slurmstepd to send
+ * an "ok" message before returning.  When the "ok" message is received,
+ * the slurmstepd has created and begun listening on its unix
+ * domain socket.
+ */
+static int
+_forkexec_slurmstepd(uint16_t type, void *req,
+		     slurm_addr_t *cli, slurm_addr_t *self,
+		     const hostset_t step_hset, uint16_t protocol_version)
+{
+	pid_t pid = 0;
+	int to_stepd[2] = {-1, -1};
+	int to_slurmd[2] = {-1, -1};
+	int rc = SLURM_SUCCESS;
+#if (SLURMSTEPD_MEMCHECK == 0)
+	int i;
+	time_t start_time = time(NULL);
+	bool prefork = conf->stepd_prefork;
+#else
+	bool prefork = false;
+#endif
+
+	if (_add_starting_step(type, req)) {
+		error("_forkexec_slurmstepd failed in _add_starting_step: %m");
+		return SLURM_ERROR;
+	}
+
+	if (!prefork || !_stepd_spare_get(to_stepd, to_slurmd)) {
+		if (pipe(to_stepd) < 0 || pipe(to_slurmd) < 0) {
+			error("_forkexec_slurmstepd pipe failed: %m");
+			if (to_stepd[0] >= 0) {
+				close(to_stepd[0]);
+				close(to_stepd[1]);
+			}
+			_remove_starting_step(type, req);
+			return SLURM_ERROR;
+		}
+		if ((pid = _spawn_slurmstepd(type, req, to_stepd,
+					     to_slurmd)) < 0) {
+			_remove_starting_step(type, req);
+			return SLURM_ERROR;
+		}
+	}
+
+	if ((rc = _send_slurmstepd_init(to_stepd[1], type,
+					req, cli, self,
+					step_hset,
+					protocol_version)) != 0) {
+		error("Unable to init slurmstepd");
+		goto done;
+	}
+
+	/* If running under valgrind/memcheck, this pipe doesn't work
+	 * correctly so just skip it. */
+#if (SLURMSTEPD_MEMCHECK == 0)
+	i = read(to_slurmd[0], &rc, sizeof(int));
+	if (i < 0) {
+		error("%s: Can not read return code from slurmstepd "
+		      "got %d: %m", __func__, i);
+		rc = SLURM_ERROR;
+	} else if (i != sizeof(int)) {
+		error("%s: slurmstepd failed to send return code "
+		      "got %d: %m", __func__, i);
+		rc = SLURM_ERROR;
+	} else {
+		int delta_time = time(NULL) - start_time;
+		int cc;
+		if (delta_time > 5) {
+			info("Warning: slurmstepd startup took %d sec, "
+			     "possible file system problem or full "
+			     "memory", delta_time);
+		}
+		if (rc != SLURM_SUCCESS)
+			error("slurmstepd return code %d", rc);
+
+		cc = SLURM_SUCCESS;
+		cc = write(to_stepd[1], &cc, sizeof(int));
+		if (cc != sizeof(int)) {
+			error("%s: failed to send ack to stepd %d: %m",
+			      __func__, cc);
+		}
+	}
+#endif
+done:
+	if (_remove_starting_step(type, req))
+		error("Error cleaning up starting_step list");
+
+	/* Reap child */
+	if ((pid > 0) && (waitpid(pid, NULL, 0) < 0))
+		error("Unable to reap slurmd child process");
+	if (close(to_stepd[1]) < 0)
+		error("close write to_stepd in parent: %m");
+	if (close(to_slurmd[0]) < 0)
+		error("close read to_slurmd in parent: %m");
+
+	/* Have the next launch use a spare slurmstepd */
+	if (prefork)
+		_stepd_spare_start();
+
+	return rc;
+}
+
 static void _setup_x11_display(uint32_t job_id, uint32_t step_id,
 			       char ***env, uint32_t *envc)
 {
@@ -4210,10 +4386,15 @@ static int _rpc_file_bcast(slurm_msg_t *msg)
 		return SLURM_ERROR;
 	}
 
+	/*
+	 * Blocks after the first may arrive in any order, so write each at
+	 * its offset in the file.
+	 */
 	offset = 0;
 	while (req->block_len - offset) {
-		inx = write(file_info->fd, &req->block[offset],
-			    (req->block_len - offset));
+		inx = pwrite(file_info->fd, &req->block[offset],
+			     (req->block_len - offset),
+			     req->block_offset + offset);
 		if (inx == -1) {
 			if ((errno == EINTR) || (errno == EAGAIN))
 				continue;
@@ -57,6 +57,9 @@ extern void record_launched_jobs(void);
 void file_bcast_init(void);
 void file_bcast_purge(void);
 
+/* Discard any spare slurmstepd kept for LaunchParameters=slurmstepd_prefork */
+extern void stepd_spare_purge(void);
+
 /*
  * ume_notify - Notify all jobs and steps on this node that a Uncorrectable
  *	Memory Error (UME) has occured by sending SIG_UME (to log event in
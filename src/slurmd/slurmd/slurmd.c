@@ -405,6 +405,7 @@ main (int argc, char **argv)
 		error("Unable to remove pidfile `%s': %m", conf->pidfile);
 
 	_wait_for_all_threads(120);
+	stepd_spare_purge();
 	_slurmd_fini();
 	_destroy_conf();
 	slurm_cred_fini();	/* must be after _destroy_conf() */
@@ -876,6 +877,8 @@ _read_config(void)
 	conf->slurm_user_id =  cf->slurm_user_id;
 
 	conf->cr_type = cf->select_type_param;
+	conf->stepd_prefork = (xstrcasestr(cf->launch_params,
+					   "slurmstepd_prefork") != NULL);
 
 	path_pubkey = xstrdup(cf->job_credential_public_certificate);
 
@@ -1120,6 +1123,7 @@ _reconfigure(void)
 	List gres_list = NULL;
 
 	_reconfig = 0;
+	stepd_spare_purge();
 	slurm_conf_reinit(conf->conffile);
 	xcgroup_reconfig_slurm_cgroup_conf();
 	_read_config();
@@ -160,6 +160,7 @@ typedef struct slurmd_config {
 	uint32_t	task_plugin_param; /* TaskPluginParams, expressed
 					 * using cpu_bind_type_t flags */
 	uint16_t	propagate_prio;	/* PropagatePrioProcess flag       */
+	bool		stepd_prefork;	/* keep a spare slurmstepd forked  */
 
 	List		starting_steps; /* steps that are starting but cannot
 					   receive RPCs yet */
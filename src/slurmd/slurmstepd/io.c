@@ -56,6 +56,7 @@
 #include <sys/socket.h>
 #include <sys/stat.h>
 #include <sys/types.h>
+#include <sys/uio.h>
 #include <termios.h>
 #include <unistd.h>
 
@@ -93,6 +94,12 @@ struct io_operations client_ops = {
 	.handle_write = &_client_write,
 };
 
+/*
+ * Maximum number of queued messages sent to a client socket with one
+ * writev() call.
+ */
+#define CLIENT_WRITE_IOV_MAX 64
+
 struct client_io_info {
 #ifndef NDEBUG
 #define CLIENT_IO_MAGIC  0x10102
@@ -427,14 +434,20 @@ _client_read(eio_obj_t *obj, List objs)
 }
 
 /*
- * Write outgoing packed messages to the client socket.
+ * Write outgoing packed messages to the client socket. The message in
+ * progress and the messages queued behind it are sent together with a
+ * single writev(), so tasks producing many small messages do not cost a
+ * system call per message.
  */
 static int
 _client_write(eio_obj_t *obj, List objs)
 {
 	struct client_io_info *client = (struct client_io_info *) obj->arg;
-	void *buf;
-	int n;
+	struct iovec iov[CLIENT_WRITE_IOV_MAX];
+	struct io_buf *msg;
+	ListIterator itr;
+	int iov_cnt = 1, total;
+	ssize_t n;
 
 	xassert(client->magic == CLIENT_IO_MAGIC);
 
@@ -458,12 +471,28 @@ _client_write(eio_obj_t *obj, List objs)
 	debug5("  client->out_remaining = %d", client->out_remaining);
 
 	/*
-	 * Write message to socket.
+	 * Gather the rest of the current message and whatever follows it
+	 * in the queue. Only this thread removes messages from the queue,
+	 * so they stay at its head until written.
 	 */
-	buf = client->out_msg->data +
+	iov[0].iov_base = client->out_msg->data +
 		(client->out_msg->length - client->out_remaining);
+	iov[0].iov_len = client->out_remaining;
+	total = client->out_remaining;
+	itr = list_iterator_create(client->msg_queue);
+	while ((iov_cnt < CLIENT_WRITE_IOV_MAX) && (msg = list_next(itr))) {
+		iov[iov_cnt].iov_base = msg->data;
+		iov[iov_cnt].iov_len = msg->length;
+		total += msg->length;
+		iov_cnt++;
+	}
+	list_iterator_destroy(itr);
+
+	/*
+	 * Write messages to socket.
+	 */
 again:
-	if ((n = write(obj->fd, buf, client->out_remaining)) < 0) {
+	if ((n = writev(obj->fd, iov, iov_cnt)) < 0) {
 		if (errno == EINTR) {
 			goto again;
 		} else if ((errno == EAGAIN) || (errno == EWOULDBLOCK)) {
@@ -475,17 +504,24 @@ again:
 			return SLURM_SUCCESS;
 		}
 	}
-	if (n < client->out_remaining) {
-		error("Only wrote %d of %d bytes to socket",
-		      n, client->out_remaining);
-	} else
-		debug5("Wrote %d bytes to socket", n);
-	client->out_remaining -= n;
-	if (client->out_remaining > 0)
-		return SLURM_SUCCESS;
+	debug5("Wrote %zd of %d bytes in %d messages to socket",
+	       n, total, iov_cnt);
 
-	_free_outgoing_msg(client->out_msg, client->job);
-	client->out_msg = NULL;
+	/*
+	 * Release every message written completely, leaving a partially
+	 * written one as the message in progress.
+	 */
+	while (n >= client->out_remaining) {
+		n -= client->out_remaining;
+		_free_outgoing_msg(client->out_msg, client->job);
+		client->out_msg = NULL;
+		if (--iov_cnt == 0)
+			break;
+		client->out_msg = list_dequeue(client->msg_queue);
+		client->out_remaining = client->out_msg->length;
+	}
+	if (client->out_msg)
+		client->out_remaining -= n;
 
 	return SLURM_SUCCESS;
 }
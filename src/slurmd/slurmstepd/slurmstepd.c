@@ -40,8 +40,10 @@
 
 #include "config.h"
 
+#include <poll.h>
 #include <signal.h>
 #include <stdlib.h>
+#include <sys/ioctl.h>
 #include <sys/mman.h>
 #include <unistd.h>
 
@@ -81,6 +83,7 @@ static void _dump_user_env(void);
 static void _send_ok_to_slurmd(int sock);
 static void _send_fail_to_slurmd(int sock);
 static void _got_ack_from_slurmd(int);
+static void _wait_for_slurmd(int sock);
 static stepd_step_rec_t *_step_setup(slurm_addr_t *cli, slurm_addr_t *self,
 				     slurm_msg_t *msg);
 #ifdef MEMORY_LEAK_DEBUG
@@ -125,6 +128,7 @@ main (int argc, char **argv)
 		fatal( "failed to initialize authentication plugin" );
 
 	/* Receive job parameters from the slurmd */
+	_wait_for_slurmd(STDIN_FILENO);
 	_init_from_slurmd(STDIN_FILENO, argv, &cli, &self, &msg);
 
 	/* Create the stepd_step_rec_t, mostly from info in a
@@ -446,6 +450,29 @@ rwfail:
 #endif
 }
 
+/*
+ * A spare slurmstepd (LaunchParameters=slurmstepd_prefork) waits here with
+ * its plugins loaded until the slurmd sends it a step. Exit if the slurmd
+ * closed the pipe instead, as when it discards the spare.
+ */
+static void _wait_for_slurmd(int sock)
+{
+	struct pollfd pfd;
+	int avail = 0;
+
+	pfd.fd = sock;
+	pfd.events = POLLIN;
+	pfd.revents = 0;
+	while ((poll(&pfd, 1, -1) < 0) && (errno == EINTR))
+		;
+	if ((pfd.revents & POLLHUP) &&
+	    (ioctl(sock, FIONREAD, &avail) == 0) && (avail == 0)) {
+		debug("%s: slurmd closed the connection without sending a step, exiting",
+		      __func__);
+		exit(0);
+	}
+}
+
 static void _set_job_log_prefix(uint32_t jobid, uint32_t stepid)
 {
 	char *buf;
@@ -675,6 +675,7 @@ static int _file_bcast(slurm_opt_t *opt_local, srun_job_t *job)
 	params->step_id = job->stepid;
 	params->timeout = 0;
 	params->verbose = 0;
+	params->window = 1;
 
 	rc = bcast_file(params);
 	if (rc == SLURM_SUCCESS) {